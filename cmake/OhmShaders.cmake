@@ -0,0 +1,34 @@
+# ohm_add_shaders( <target> NAME <name> SOURCES <glsl files...> [DESTINATION <dir>] )
+#
+# Compiles GLSL stages into <dir>/<name>.osh with oshc while building, and
+# makes <target> depend on it. The .osh is rebuilt whenever a source or oshc
+# itself changes. <dir> defaults to the runtime output directory, next to the
+# executables that load it.
+function( ohm_add_shaders target )
+  cmake_parse_arguments( OSH "" "NAME;DESTINATION" "SOURCES" ${ARGN} )
+
+  if( NOT OSH_NAME OR NOT OSH_SOURCES )
+    message( FATAL_ERROR "ohm_add_shaders: NAME and SOURCES are required." )
+  endif()
+
+  if( NOT OSH_DESTINATION )
+    set( OSH_DESTINATION ${CMAKE_RUNTIME_OUTPUT_DIRECTORY} )
+  endif()
+
+  set( sources "" )
+  foreach( source ${OSH_SOURCES} )
+    get_filename_component( source ${source} ABSOLUTE )
+    list( APPEND sources ${source} )
+  endforeach()
+
+  set( output ${OSH_DESTINATION}/${OSH_NAME}.osh )
+  add_custom_command( OUTPUT  ${output}
+                      COMMAND ${CMAKE_COMMAND} -E make_directory ${OSH_DESTINATION}
+                      COMMAND $<TARGET_FILE:oshc> -o ${output} ${sources}
+                      DEPENDS oshc ${sources}
+                      COMMENT "Compiling shader ${OSH_NAME}.osh"
+                      VERBATIM )
+
+  add_custom_target( ${target}_${OSH_NAME}_osh DEPENDS ${output} )
+  add_dependencies ( ${target} ${target}_${OSH_NAME}_osh )
+endfunction()
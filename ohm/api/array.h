@@ -23,6 +23,13 @@ class Array {
   auto byte_size() const -> size_t;
   auto handle() const -> int32_t;
 
+  /** Method to retrieve this array's index in the bindless heap, which stays
+   * the same for the array's lifetime.
+   * @return The index, or -1 if bindless mode is off for its device or the
+   * array isn't in the heap, like one that was never created.
+   */
+  auto bindless() const -> int32_t;
+
  private:
   int32_t m_handle;
   size_t m_count;
@@ -129,6 +136,11 @@ template <typename API, typename Type, class Allocator>
 auto Array<API, Type, Allocator>::handle() const -> int32_t {
   return this->m_handle;
 }
+
+template <typename API, typename Type, class Allocator>
+auto Array<API, Type, Allocator>::bindless() const -> int32_t {
+  return API::Array::bindless(this->m_handle);
+}
 }  // namespace ohm
 
 /** Required functions of API
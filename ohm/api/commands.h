@@ -1,5 +1,9 @@
 #pragma once
 #include <algorithm>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
 #include "array.h"
 #include "descriptor.h"
 #include "image.h"
@@ -24,6 +28,82 @@ enum class Filter : int {
   Cubic,
 };
 
+/** Argument records consumed by the indirect commands. These match the layout
+ * the GPU expects, so an Array of them can be filled in by a kernel and handed
+ * straight to Commands::dispatchIndirect/drawIndirect/drawIndexedIndirect.
+ */
+struct DispatchCommand {
+  uint32_t x;
+  uint32_t y;
+  uint32_t z;
+};
+
+struct DrawCommand {
+  uint32_t vertex_count;
+  uint32_t instance_count;
+  uint32_t first_vertex;
+  uint32_t first_instance;
+};
+
+struct DrawIndexedCommand {
+  uint32_t index_count;
+  uint32_t instance_count;
+  uint32_t first_index;
+  int32_t vertex_offset;
+  uint32_t first_instance;
+};
+
+/** Region of a copy between two Arrays. Offsets and count are in elements.
+ */
+struct ArrayRegion {
+  size_t src_offset = 0;
+  size_t dst_offset = 0;
+  size_t count = 0;
+};
+
+/** Region of a copy between an Array and an Image.
+ * The array offset is in elements, the image offset and extent in texels of
+ * the chosen mip level. A zero width/height covers the rest of that level.
+ */
+struct ImageRegion {
+  size_t array_offset = 0;
+  size_t x = 0;
+  size_t y = 0;
+  size_t width = 0;
+  size_t height = 0;
+  size_t layer = 0;
+  size_t layer_count = 1;
+  size_t mip = 0;
+};
+
+/** Region of a copy between two Images. Offsets and extent are in texels of
+ * the source mip level. A zero width/height covers the rest of that level.
+ */
+struct ImageCopyRegion {
+  size_t src_x = 0;
+  size_t src_y = 0;
+  size_t dst_x = 0;
+  size_t dst_y = 0;
+  size_t width = 0;
+  size_t height = 0;
+  size_t src_layer = 0;
+  size_t dst_layer = 0;
+  size_t layer_count = 1;
+  size_t src_mip = 0;
+  size_t dst_mip = 0;
+};
+
+/** GPU timing of one profiling scope. The invocation counts are only filled
+ * in for outermost scopes, and only when pipeline statistics were requested.
+ */
+struct ScopeTiming {
+  std::string name;
+  double milliseconds = 0.0;
+  uint64_t vertex_invocations = 0;
+  uint64_t fragment_invocations = 0;
+  uint64_t compute_invocations = 0;
+};
+
 template <typename API, QueueType Queue = QueueType::Graphics>
 class Commands {
  public:
@@ -63,6 +143,26 @@ class Commands {
   auto copy(const Array<API, Type, Allocator>& src, Type* dst, size_t count = 0)
       -> void;
 
+  /** Region copies. Every region is recorded into a single copy command, so
+   * scattered updates of large arrays don't need a whole-buffer copy.
+   */
+  template <typename Type, typename Allocator>
+  auto copy(const Array<API, Type, Allocator>& src,
+            Array<API, Type, Allocator>& dst,
+            const std::vector<ArrayRegion>& regions) -> void;
+
+  template <typename Type, typename Allocator>
+  auto copy(const Array<API, Type, Allocator>& src, Image<API, Allocator>& dst,
+            const std::vector<ImageRegion>& regions) -> void;
+
+  template <typename Type, typename Allocator>
+  auto copy(const Image<API, Allocator>& src, Array<API, Type, Allocator>& dst,
+            const std::vector<ImageRegion>& regions) -> void;
+
+  template <typename Allocator>
+  auto copy(const Image<API, Allocator>& src, Image<API, Allocator>& dst,
+            const std::vector<ImageCopyRegion>& regions) -> void;
+
   template <typename Type, typename Type2, typename Allocator>
   auto draw(const Array<API, Type, Allocator>& indices,
             const Array<API, Type2, Allocator>& vertices,
@@ -72,7 +172,79 @@ class Commands {
   auto draw(const Array<API, Type, Allocator>& vertices,
             size_t instance_count = 1) -> void;
 
+  template <typename Type, typename Allocator>
+  auto drawIndirect(const Array<API, Type, Allocator>& vertices,
+                    const Array<API, DrawCommand, Allocator>& args,
+                    size_t draw_count = 1, size_t offset = 0) -> void;
+
+  template <typename Type, typename Allocator>
+  auto drawIndirect(const Array<API, Type, Allocator>& vertices,
+                    const Array<API, DrawCommand, Allocator>& args,
+                    const Array<API, uint32_t, Allocator>& count,
+                    size_t max_draws) -> void;
+
+  template <typename Type, typename Type2, typename Allocator>
+  auto drawIndexedIndirect(const Array<API, Type, Allocator>& indices,
+                           const Array<API, Type2, Allocator>& vertices,
+                           const Array<API, DrawIndexedCommand, Allocator>& args,
+                           size_t draw_count = 1, size_t offset = 0) -> void;
+
+  template <typename Type, typename Type2, typename Allocator>
+  auto drawIndexedIndirect(const Array<API, Type, Allocator>& indices,
+                           const Array<API, Type2, Allocator>& vertices,
+                           const Array<API, DrawIndexedCommand, Allocator>& args,
+                           const Array<API, uint32_t, Allocator>& count,
+                           size_t max_draws) -> void;
+
+  /** Fills a range of an Array with a repeated 32-bit value on the GPU, with
+   * no host staging. The offset and count are in elements, and a count of 0
+   * fills to the end of the Array. The range must be 4-byte aligned.
+   */
+  template <typename Type, typename Allocator>
+  auto fill(Array<API, Type, Allocator>& array, uint32_t value,
+            size_t offset = 0, size_t count = 0) -> void;
+
+  /** Patches a small range of an Array with host data recorded inline in the
+   * command buffer. Limited to 65536 bytes, in multiples of 4 bytes.
+   */
+  template <typename Type, typename Allocator>
+  auto update(Array<API, Type, Allocator>& array, const Type* src,
+              size_t count, size_t offset = 0) -> void;
+
+  /** Makes every write recorded so far visible to every command recorded
+   * after it. A full memory barrier; Graph inserts these between passes.
+   */
+  auto barrier() -> void;
+
   auto dispatch(size_t x, size_t y, size_t z = 1) -> void;
+
+  template <typename Allocator>
+  auto dispatchIndirect(const Array<API, DispatchCommand, Allocator>& args,
+                        size_t offset = 0) -> void;
+
+  /** Writes a value into the bound pipeline's push constant block at the
+   * given byte offset. The block's size comes from the pipeline's shader
+   * reflection, so a pipeline must be bound before pushing.
+   */
+  template <typename Type>
+  auto push(const Type& value, size_t offset = 0) -> void;
+
+  /** Enables or disables GPU profiling scopes for this object. Must be set
+   * before begin(). While disabled, scopes are not recorded at all.
+   * @param statistics Whether to also gather pipeline statistics.
+   */
+  auto profile(bool enable, bool statistics = false) -> void;
+
+  /** Opens and closes a named profiling scope. Scopes may nest.
+   */
+  auto beginScope(std::string_view name) -> void;
+  auto endScope() -> void;
+
+  /** Timings of the scopes of the most recently completed submission. These
+   * are resolved without stalling, so they lag a few submissions behind.
+   */
+  auto scopes() const -> std::vector<ScopeTiming>;
+
   auto detach() -> void;
   auto combine(const Commands& child) -> void;
   auto operator=(Commands<API, Queue>& cpy) = delete;
@@ -83,6 +255,11 @@ class Commands {
   auto bind(const Descriptor<API>& desc);
   auto handle() const -> int32_t;
   auto gpu() const -> int;
+
+  /** Number of pipeline, descriptor, vertex and index binds skipped since the
+   * last begin() because the same state was already bound.
+   */
+  auto skippedBinds() const -> size_t;
   auto synchronize() -> void;
   auto submit() -> void;
 
@@ -190,6 +367,46 @@ auto Commands<API, Queue>::copy(const Type* src,
                             dst.handle(), count);
 }
 
+template <typename API, QueueType Queue>
+template <typename Type, typename Allocator>
+auto Commands<API, Queue>::copy(const Array<API, Type, Allocator>& src,
+                                Array<API, Type, Allocator>& dst,
+                                const std::vector<ArrayRegion>& regions)
+    -> void {
+  API::Commands::copy_array(this->m_handle, src.handle(), dst.handle(),
+                            regions.data(), regions.size());
+}
+
+template <typename API, QueueType Queue>
+template <typename Type, typename Allocator>
+auto Commands<API, Queue>::copy(const Array<API, Type, Allocator>& src,
+                                Image<API, Allocator>& dst,
+                                const std::vector<ImageRegion>& regions)
+    -> void {
+  API::Commands::copy_to_image(this->m_handle, src.handle(), dst.handle(),
+                               regions.data(), regions.size());
+}
+
+template <typename API, QueueType Queue>
+template <typename Type, typename Allocator>
+auto Commands<API, Queue>::copy(const Image<API, Allocator>& src,
+                                Array<API, Type, Allocator>& dst,
+                                const std::vector<ImageRegion>& regions)
+    -> void {
+  API::Commands::copy_from_image(this->m_handle, src.handle(), dst.handle(),
+                                 regions.data(), regions.size());
+}
+
+template <typename API, QueueType Queue>
+template <typename Allocator>
+auto Commands<API, Queue>::copy(const Image<API, Allocator>& src,
+                                Image<API, Allocator>& dst,
+                                const std::vector<ImageCopyRegion>& regions)
+    -> void {
+  API::Commands::copy_image(this->m_handle, src.handle(), dst.handle(),
+                            regions.data(), regions.size());
+}
+
 template <typename API, QueueType Queue>
 template <typename Type, typename Type2, typename Allocator>
 auto Commands<API, Queue>::draw(const Array<API, Type, Allocator>& indices,
@@ -205,11 +422,110 @@ auto Commands<API, Queue>::draw(const Array<API, Type, Allocator>& vertices,
   API::Commands::draw(this->m_handle, vertices.handle(), instance_count);
 }
 
+template <typename API, QueueType Queue>
+template <typename Type, typename Allocator>
+auto Commands<API, Queue>::drawIndirect(
+    const Array<API, Type, Allocator>& vertices,
+    const Array<API, DrawCommand, Allocator>& args, size_t draw_count,
+    size_t offset) -> void {
+  API::Commands::draw_indirect(this->m_handle, vertices.handle(), args.handle(),
+                               draw_count, offset);
+}
+
+template <typename API, QueueType Queue>
+template <typename Type, typename Allocator>
+auto Commands<API, Queue>::drawIndirect(
+    const Array<API, Type, Allocator>& vertices,
+    const Array<API, DrawCommand, Allocator>& args,
+    const Array<API, uint32_t, Allocator>& count, size_t max_draws) -> void {
+  API::Commands::draw_indirect_count(this->m_handle, vertices.handle(),
+                                     args.handle(), count.handle(), max_draws);
+}
+
+template <typename API, QueueType Queue>
+template <typename Type, typename Type2, typename Allocator>
+auto Commands<API, Queue>::drawIndexedIndirect(
+    const Array<API, Type, Allocator>& indices,
+    const Array<API, Type2, Allocator>& vertices,
+    const Array<API, DrawIndexedCommand, Allocator>& args, size_t draw_count,
+    size_t offset) -> void {
+  API::Commands::draw_indexed_indirect(this->m_handle, indices.handle(),
+                                       vertices.handle(), args.handle(),
+                                       draw_count, offset);
+}
+
+template <typename API, QueueType Queue>
+template <typename Type, typename Type2, typename Allocator>
+auto Commands<API, Queue>::drawIndexedIndirect(
+    const Array<API, Type, Allocator>& indices,
+    const Array<API, Type2, Allocator>& vertices,
+    const Array<API, DrawIndexedCommand, Allocator>& args,
+    const Array<API, uint32_t, Allocator>& count, size_t max_draws) -> void {
+  API::Commands::draw_indexed_indirect_count(
+      this->m_handle, indices.handle(), vertices.handle(), args.handle(),
+      count.handle(), max_draws);
+}
+
 template <typename API, QueueType Queue>
 auto Commands<API, Queue>::dispatch(size_t x, size_t y, size_t z) -> void {
   API::Commands::dispatch(this->m_handle, x, y, z);
 }
 
+template <typename API, QueueType Queue>
+template <typename Allocator>
+auto Commands<API, Queue>::dispatchIndirect(
+    const Array<API, DispatchCommand, Allocator>& args, size_t offset) -> void {
+  API::Commands::dispatch_indirect(this->m_handle, args.handle(), offset);
+}
+
+template <typename API, QueueType Queue>
+template <typename Type, typename Allocator>
+auto Commands<API, Queue>::fill(Array<API, Type, Allocator>& array,
+                                uint32_t value, size_t offset, size_t count)
+    -> void {
+  API::Commands::fill(this->m_handle, array.handle(), value, offset, count);
+}
+
+template <typename API, QueueType Queue>
+template <typename Type, typename Allocator>
+auto Commands<API, Queue>::update(Array<API, Type, Allocator>& array,
+                                  const Type* src, size_t count, size_t offset)
+    -> void {
+  API::Commands::update(this->m_handle, array.handle(),
+                        static_cast<const void*>(src), count, offset);
+}
+
+template <typename API, QueueType Queue>
+auto Commands<API, Queue>::barrier() -> void {
+  API::Commands::barrier(this->m_handle);
+}
+
+template <typename API, QueueType Queue>
+template <typename Type>
+auto Commands<API, Queue>::push(const Type& value, size_t offset) -> void {
+  API::Commands::push(this->m_handle, &value, sizeof(Type), offset);
+}
+
+template <typename API, QueueType Queue>
+auto Commands<API, Queue>::profile(bool enable, bool statistics) -> void {
+  API::Commands::profile(this->m_handle, enable, statistics);
+}
+
+template <typename API, QueueType Queue>
+auto Commands<API, Queue>::beginScope(std::string_view name) -> void {
+  API::Commands::begin_scope(this->m_handle, name);
+}
+
+template <typename API, QueueType Queue>
+auto Commands<API, Queue>::endScope() -> void {
+  API::Commands::end_scope(this->m_handle);
+}
+
+template <typename API, QueueType Queue>
+auto Commands<API, Queue>::scopes() const -> std::vector<ScopeTiming> {
+  return API::Commands::scopes(this->m_handle);
+}
+
 template <typename API, QueueType Queue>
 auto Commands<API, Queue>::detach() -> void {
   API::Commands::detatch(this->m_handle);
@@ -256,6 +572,11 @@ auto Commands<API, Queue>::handle() const -> int32_t {
   return this->m_handle;
 }
 
+template <typename API, QueueType Queue>
+auto Commands<API, Queue>::skippedBinds() const -> size_t {
+  return API::Commands::skipped_binds(this->m_handle);
+}
+
 template <typename API, QueueType Queue>
 auto Commands<API, Queue>::synchronize() -> void {
   API::Commands::synchronize(this->m_handle);
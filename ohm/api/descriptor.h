@@ -2,11 +2,25 @@
 #include "array.h"
 #include "image.h"
 #include "memory.h"
+#include <cstdint>
 #include <vector>
 #include <utility>
 #include <string>
+#include <string_view>
 
 namespace ohm {
+/** Hashes a shader variable's name for Pipeline::binding. Names known at
+ * compile time are hashed at compile time.
+ */
+constexpr auto bindingHash(std::string_view name) -> uint64_t {
+  auto hash = uint64_t(0xcbf29ce484222325ull);
+  for (auto c : name) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= 0x100000001b3ull;
+  }
+  return hash;
+}
+
 template <typename API>
 class Pipeline;
 
@@ -30,6 +44,25 @@ class Descriptor {
   template <typename Allocator>
   auto bind(std::string_view name, const Image<API, Allocator>& image) -> void;
 
+  /** Binding by an ID from Pipeline::binding, which skips looking the
+   * variable up by name. IDs are valid for every descriptor of the pipeline.
+   */
+  template <typename Type, typename Allocator>
+  auto bind(int32_t binding, const Array<API, Type, Allocator>& array) -> void;
+
+  template <typename Allocator>
+  auto bind(int32_t binding, const Image<API, Allocator>* images, size_t amt)
+      -> void;
+
+  template <typename Allocator>
+  auto bind(int32_t binding, const Image<API, Allocator>& image) -> void;
+
+  /** Method to apply every bind made since the last commit in one update.
+   * Binds are only staged until then, or until the descriptor is bound to
+   * commands, which commits for you.
+   */
+  auto commit() -> void;
+
  private:
   friend class Pipeline<API>;
   Descriptor(int32_t handle, const Pipeline<API>* parent);
@@ -95,10 +128,10 @@ auto Descriptor<API>::bind(std::string_view name,
                            const Image<API, Allocator>* images, size_t amt)
     -> void {
   auto tmp = std::vector<int32_t>();
-  for (auto index = 0; index < amt; index++)
+  for (auto index = 0u; index < amt; index++)
     tmp.push_back(images[index].handle());
 
-  API::Descriptor::bind_images(this->m_handle, tmp);
+  API::Descriptor::bind_images(this->m_handle, name, tmp);
 }
 
 template <typename API>
@@ -107,4 +140,35 @@ auto Descriptor<API>::bind(std::string_view name,
                            const Image<API, Allocator>& image) -> void {
   API::Descriptor::bind_image(this->m_handle, name, image.handle());
 }
+
+template <typename API>
+auto Descriptor<API>::commit() -> void {
+  API::Descriptor::commit(this->m_handle);
+}
+
+template <typename API>
+template <typename Type, typename Allocator>
+auto Descriptor<API>::bind(int32_t binding,
+                           const Array<API, Type, Allocator>& array) -> void {
+  API::Descriptor::bind_array(this->m_handle, binding, array.handle());
+}
+
+template <typename API>
+template <typename Allocator>
+auto Descriptor<API>::bind(int32_t binding,
+                           const Image<API, Allocator>* images, size_t amt)
+    -> void {
+  auto tmp = std::vector<int32_t>();
+  for (auto index = 0u; index < amt; index++)
+    tmp.push_back(images[index].handle());
+
+  API::Descriptor::bind_images(this->m_handle, binding, tmp);
+}
+
+template <typename API>
+template <typename Allocator>
+auto Descriptor<API>::bind(int32_t binding, const Image<API, Allocator>& image)
+    -> void {
+  API::Descriptor::bind_image(this->m_handle, binding, image.handle());
+}
 }  // namespace ohm
\ No newline at end of file
@@ -0,0 +1,467 @@
+#pragma once
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "array.h"
+#include "commands.h"
+#include "exception.h"
+#include "image.h"
+#include "memory.h"
+
+namespace ohm {
+/** Id of a resource declared to a Graph.
+ */
+using GraphResource = size_t;
+
+/** Object to schedule a frame's worth of GPU work as a graph of passes.
+ * Each pass declares the resources it reads and writes. On compile() the graph
+ * culls passes whose writes are never consumed, places transient arrays with
+ * non-overlapping lifetimes in the same memory, and works out where barriers
+ * are needed, so execute() only has to record.
+ *
+ * Passes run in the order they were added. Imported resources and ones marked
+ * with output() are what keep passes alive.
+ */
+template <typename API, typename Allocator = DefaultAllocator<API>,
+          QueueType Queue = QueueType::Graphics>
+class Graph {
+ public:
+  using Pass = std::function<void(Commands<API, Queue>&)>;
+
+  Graph();
+  explicit Graph(int gpu);
+  Graph(const Graph& cpy) = delete;
+  ~Graph();
+  auto operator=(const Graph& cpy) -> Graph& = delete;
+
+  /** Method to track an array that lives outside of the graph.
+   */
+  template <typename Type>
+  auto import(Array<API, Type, Allocator>& array) -> GraphResource;
+
+  /** Method to track an image that lives outside of the graph.
+   */
+  auto import(Image<API, Allocator>& image) -> GraphResource;
+
+  /** Method to declare an array owned by the graph. It only exists while the
+   * passes using it run, and may share memory with other transients.
+   */
+  template <typename Type>
+  auto create(size_t count) -> GraphResource;
+
+  /** Method to mark a resource as consumed outside the graph, so the passes
+   * writing it are kept.
+   */
+  auto output(GraphResource resource) -> void;
+
+  auto addPass(std::string_view name, const std::vector<GraphResource>& reads,
+               const std::vector<GraphResource>& writes, Pass pass) -> void;
+
+  /** Method to access an array resource. Transients only exist once the graph
+   * is compiled, so this is meant to be called from inside a pass.
+   */
+  template <typename Type>
+  auto array(GraphResource resource) -> Array<API, Type, Allocator>&;
+
+  auto image(GraphResource resource) -> Image<API, Allocator>&;
+
+  auto compile() -> void;
+
+  /** Method to record every live pass into the graph's commands and submit
+   * them. Compiles first if the graph changed since the last compile.
+   */
+  auto execute() -> void;
+
+  auto commands() -> Commands<API, Queue>&;
+
+  /** Number of passes culled by the last compile.
+   */
+  auto culled() const -> size_t;
+
+  /** Number of barriers execute() records.
+   */
+  auto barriers() const -> size_t;
+
+  /** Bytes of the memory block backing all transients.
+   */
+  auto transientSize() const -> size_t;
+
+  /** Bytes saved by aliasing, compared to giving each transient its own
+   * memory.
+   */
+  auto aliasedSize() const -> size_t;
+
+ private:
+  static constexpr auto NO_PASS = std::numeric_limits<size_t>::max();
+  static constexpr auto ALIGNMENT = size_t(256);
+
+  using Factory = std::function<std::shared_ptr<void>(
+      const Memory<API, Allocator>&, size_t)>;
+
+  struct Resource {
+    void* external = nullptr;
+    std::shared_ptr<void> storage;
+    Factory factory;
+    size_t element = 0;
+    size_t size = 0;
+    size_t offset = 0;
+    size_t first = NO_PASS;
+    size_t last = NO_PASS;
+    bool transient = false;
+    bool image = false;
+    bool output = false;
+  };
+
+  struct PassData {
+    std::string name;
+    std::vector<GraphResource> reads;
+    std::vector<GraphResource> writes;
+    Pass pass;
+    bool culled = false;
+    bool barrier = false;
+  };
+
+  auto cull() -> void;
+  auto place() -> void;
+  auto schedule() -> void;
+  auto aliases(GraphResource a, GraphResource b) const -> bool;
+
+  int m_gpu;
+  Memory<API, Allocator> m_memory;
+  std::vector<Resource> m_resources;
+
+  // Declared after the memory and resources its work uses, so it's destroyed
+  // before them.
+  Commands<API, Queue> m_commands;
+  std::vector<PassData> m_passes;
+  size_t m_culled;
+  size_t m_barriers;
+  size_t m_transient_size;
+  size_t m_requested_size;
+  bool m_compiled;
+};
+
+template <typename API, typename Allocator, QueueType Queue>
+Graph<API, Allocator, Queue>::Graph() {
+  this->m_gpu = -1;
+  this->m_culled = 0;
+  this->m_barriers = 0;
+  this->m_transient_size = 0;
+  this->m_requested_size = 0;
+  this->m_compiled = false;
+}
+
+template <typename API, typename Allocator, QueueType Queue>
+Graph<API, Allocator, Queue>::Graph(int gpu) : m_commands(gpu) {
+  this->m_gpu = gpu;
+  this->m_culled = 0;
+  this->m_barriers = 0;
+  this->m_transient_size = 0;
+  this->m_requested_size = 0;
+  this->m_compiled = false;
+}
+
+template <typename API, typename Allocator, QueueType Queue>
+Graph<API, Allocator, Queue>::~Graph() {
+  if (this->m_gpu >= 0) this->m_commands.synchronize();
+}
+
+template <typename API, typename Allocator, QueueType Queue>
+template <typename Type>
+auto Graph<API, Allocator, Queue>::import(Array<API, Type, Allocator>& array)
+    -> GraphResource {
+  auto resource = Resource();
+  resource.external = &array;
+  resource.element = sizeof(Type);
+  resource.output = true;
+
+  this->m_resources.push_back(std::move(resource));
+  this->m_compiled = false;
+  return this->m_resources.size() - 1;
+}
+
+template <typename API, typename Allocator, QueueType Queue>
+auto Graph<API, Allocator, Queue>::import(Image<API, Allocator>& image)
+    -> GraphResource {
+  auto resource = Resource();
+  resource.external = &image;
+  resource.image = true;
+  resource.output = true;
+
+  this->m_resources.push_back(std::move(resource));
+  this->m_compiled = false;
+  return this->m_resources.size() - 1;
+}
+
+template <typename API, typename Allocator, QueueType Queue>
+template <typename Type>
+auto Graph<API, Allocator, Queue>::create(size_t count) -> GraphResource {
+  OhmException(this->m_gpu < 0, Error::LogicError,
+               "Attempting to create a transient on a graph with no gpu.");
+
+  // The buffer's real requirements decide its footprint, so probe them once.
+  auto probe = API::Array::create(this->m_gpu, count, sizeof(Type));
+  auto required = API::Array::required(probe);
+  API::Array::destroy(probe);
+
+  auto resource = Resource();
+  resource.transient = true;
+  resource.element = sizeof(Type);
+  resource.size = (required + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+  resource.factory = [count](const Memory<API, Allocator>& memory,
+                             size_t offset) -> std::shared_ptr<void> {
+    return std::make_shared<Array<API, Type, Allocator>>(
+        Memory<API, Allocator>(memory, offset), count);
+  };
+
+  this->m_resources.push_back(std::move(resource));
+  this->m_compiled = false;
+  return this->m_resources.size() - 1;
+}
+
+template <typename API, typename Allocator, QueueType Queue>
+auto Graph<API, Allocator, Queue>::output(GraphResource resource) -> void {
+  OhmException(resource >= this->m_resources.size(), Error::LogicError,
+               "Attempting to output a resource not declared to this graph.");
+  this->m_resources[resource].output = true;
+  this->m_compiled = false;
+}
+
+template <typename API, typename Allocator, QueueType Queue>
+auto Graph<API, Allocator, Queue>::addPass(
+    std::string_view name, const std::vector<GraphResource>& reads,
+    const std::vector<GraphResource>& writes, Pass pass) -> void {
+  auto data = PassData();
+  data.name = std::string(name);
+  data.reads = reads;
+  data.writes = writes;
+  data.pass = std::move(pass);
+
+  for (auto resource : reads) {
+    OhmException(resource >= this->m_resources.size(), Error::LogicError,
+                 "Attempting to read a resource not declared to this graph.");
+    (void)resource;
+  }
+  for (auto resource : writes) {
+    OhmException(resource >= this->m_resources.size(), Error::LogicError,
+                 "Attempting to write a resource not declared to this graph.");
+    (void)resource;
+  }
+
+  this->m_passes.push_back(std::move(data));
+  this->m_compiled = false;
+}
+
+template <typename API, typename Allocator, QueueType Queue>
+template <typename Type>
+auto Graph<API, Allocator, Queue>::array(GraphResource resource)
+    -> Array<API, Type, Allocator>& {
+  auto& res = this->m_resources[resource];
+  OhmException(res.image || res.element != sizeof(Type), Error::LogicError,
+               "Attempting to access a graph resource as the wrong type.");
+  OhmException(res.transient && !res.storage, Error::LogicError,
+               "Attempting to access a transient that is not allocated.");
+
+  auto* ptr = res.transient ? res.storage.get() : res.external;
+  return *static_cast<Array<API, Type, Allocator>*>(ptr);
+}
+
+template <typename API, typename Allocator, QueueType Queue>
+auto Graph<API, Allocator, Queue>::image(GraphResource resource)
+    -> Image<API, Allocator>& {
+  auto& res = this->m_resources[resource];
+  OhmException(!res.image, Error::LogicError,
+               "Attempting to access a graph resource as the wrong type.");
+  return *static_cast<Image<API, Allocator>*>(res.external);
+}
+
+template <typename API, typename Allocator, QueueType Queue>
+auto Graph<API, Allocator, Queue>::compile() -> void {
+  // Work from the last execute may still use the storage released below.
+  if (this->m_gpu >= 0) this->m_commands.synchronize();
+
+  for (auto& resource : this->m_resources) {
+    resource.storage.reset();
+    resource.first = NO_PASS;
+    resource.last = NO_PASS;
+  }
+
+  // Memory's move assignment doesn't release what it replaces, so drop the
+  // old block explicitly before placing a new one.
+  auto released = Memory<API, Allocator>(std::move(this->m_memory));
+
+  this->cull();
+  this->place();
+  this->schedule();
+  this->m_compiled = true;
+}
+
+template <typename API, typename Allocator, QueueType Queue>
+auto Graph<API, Allocator, Queue>::execute() -> void {
+  if (!this->m_compiled) this->compile();
+
+  this->m_commands.begin();
+  for (auto& pass : this->m_passes) {
+    if (pass.culled) continue;
+    if (pass.barrier) this->m_commands.barrier();
+    pass.pass(this->m_commands);
+  }
+  this->m_commands.submit();
+}
+
+template <typename API, typename Allocator, QueueType Queue>
+auto Graph<API, Allocator, Queue>::commands() -> Commands<API, Queue>& {
+  return this->m_commands;
+}
+
+template <typename API, typename Allocator, QueueType Queue>
+auto Graph<API, Allocator, Queue>::culled() const -> size_t {
+  return this->m_culled;
+}
+
+template <typename API, typename Allocator, QueueType Queue>
+auto Graph<API, Allocator, Queue>::barriers() const -> size_t {
+  return this->m_barriers;
+}
+
+template <typename API, typename Allocator, QueueType Queue>
+auto Graph<API, Allocator, Queue>::transientSize() const -> size_t {
+  return this->m_transient_size;
+}
+
+template <typename API, typename Allocator, QueueType Queue>
+auto Graph<API, Allocator, Queue>::aliasedSize() const -> size_t {
+  return this->m_requested_size - this->m_transient_size;
+}
+
+template <typename API, typename Allocator, QueueType Queue>
+auto Graph<API, Allocator, Queue>::cull() -> void {
+  auto needed = std::vector<bool>(this->m_resources.size(), false);
+  for (auto index = 0u; index < this->m_resources.size(); index++) {
+    needed[index] = this->m_resources[index].output;
+  }
+
+  // Walking backwards, a pass lives if anything after it consumes a write.
+  this->m_culled = 0;
+  for (auto index = this->m_passes.size(); index > 0; index--) {
+    auto& pass = this->m_passes[index - 1];
+    pass.culled = std::none_of(pass.writes.begin(), pass.writes.end(),
+                               [&needed](auto res) { return needed[res]; });
+    if (pass.culled) {
+      this->m_culled++;
+      continue;
+    }
+    for (auto res : pass.reads) needed[res] = true;
+  }
+
+  for (auto index = 0u; index < this->m_passes.size(); index++) {
+    auto& pass = this->m_passes[index];
+    auto touch = [this, index](GraphResource res) {
+      auto& resource = this->m_resources[res];
+      if (resource.first == NO_PASS) resource.first = index;
+      resource.last = index;
+    };
+
+    if (pass.culled) continue;
+    for (auto res : pass.reads) touch(res);
+    for (auto res : pass.writes) touch(res);
+  }
+}
+
+template <typename API, typename Allocator, QueueType Queue>
+auto Graph<API, Allocator, Queue>::place() -> void {
+  auto order = std::vector<GraphResource>();
+  for (auto index = 0u; index < this->m_resources.size(); index++) {
+    auto& resource = this->m_resources[index];
+    if (resource.transient && resource.first != NO_PASS) order.push_back(index);
+  }
+
+  // Largest first, each at the lowest offset clear of every transient alive at
+  // the same time.
+  std::stable_sort(order.begin(), order.end(), [this](auto a, auto b) {
+    return this->m_resources[a].size > this->m_resources[b].size;
+  });
+
+  this->m_transient_size = 0;
+  this->m_requested_size = 0;
+  auto placed = std::vector<GraphResource>();
+  for (auto res : order) {
+    auto& resource = this->m_resources[res];
+    auto taken = std::vector<std::pair<size_t, size_t>>();
+    for (auto other : placed) {
+      auto& cmp = this->m_resources[other];
+      if (cmp.first <= resource.last && resource.first <= cmp.last) {
+        taken.push_back({cmp.offset, cmp.offset + cmp.size});
+      }
+    }
+    std::sort(taken.begin(), taken.end());
+
+    resource.offset = 0;
+    for (auto& range : taken) {
+      if (resource.offset + resource.size <= range.first) break;
+      resource.offset = std::max(resource.offset, range.second);
+    }
+
+    placed.push_back(res);
+    this->m_requested_size += resource.size;
+    this->m_transient_size =
+        std::max(this->m_transient_size, resource.offset + resource.size);
+  }
+
+  if (this->m_transient_size == 0) return;
+  this->m_memory = Memory<API, Allocator>(this->m_gpu, HeapType::GpuOnly,
+                                          this->m_transient_size);
+  for (auto res : placed) {
+    auto& resource = this->m_resources[res];
+    resource.storage = resource.factory(this->m_memory, resource.offset);
+  }
+}
+
+template <typename API, typename Allocator, QueueType Queue>
+auto Graph<API, Allocator, Queue>::schedule() -> void {
+  auto written = std::vector<bool>(this->m_resources.size(), false);
+  auto read = std::vector<bool>(this->m_resources.size(), false);
+
+  // Since barriers are global, any hazard flushes every pending access.
+  this->m_barriers = 0;
+  for (auto& pass : this->m_passes) {
+    pass.barrier = false;
+    if (pass.culled) continue;
+
+    for (auto other = 0u; other < this->m_resources.size(); other++) {
+      for (auto res : pass.reads) {
+        pass.barrier |= written[other] && this->aliases(res, other);
+      }
+      for (auto res : pass.writes) {
+        pass.barrier |=
+            (written[other] || read[other]) && this->aliases(res, other);
+      }
+    }
+
+    if (pass.barrier) {
+      std::fill(written.begin(), written.end(), false);
+      std::fill(read.begin(), read.end(), false);
+      this->m_barriers++;
+    }
+    for (auto res : pass.reads) read[res] = true;
+    for (auto res : pass.writes) written[res] = true;
+  }
+}
+
+template <typename API, typename Allocator, QueueType Queue>
+auto Graph<API, Allocator, Queue>::aliases(GraphResource a,
+                                           GraphResource b) const -> bool {
+  if (a == b) return true;
+
+  auto& lhs = this->m_resources[a];
+  auto& rhs = this->m_resources[b];
+  if (!lhs.storage || !rhs.storage) return false;
+  return lhs.offset < rhs.offset + rhs.size &&
+         rhs.offset < lhs.offset + lhs.size;
+}
+}  // namespace ohm
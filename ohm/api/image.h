@@ -86,6 +86,13 @@ class Image {
   auto layers() const -> size_t;
   auto gpu() const -> int;
   auto handle() const -> int32_t;
+
+  /** Method to retrieve this image's index in the bindless heap, which stays
+   * the same for the image's lifetime.
+   * @return The index, or -1 if bindless mode is off for its device or the
+   * image isn't in the heap, like one without sampled or storage usage.
+   */
+  auto bindless() const -> int32_t;
   auto layer(size_t index) -> Image<API, Allocator>;
   auto memory() -> const Memory<API, Allocator>&;
   auto format() -> ImageFormat;
@@ -171,6 +178,11 @@ auto Image<API, Allocator>::handle() const -> int32_t {
   return this->m_handle;
 }
 
+template <typename API, typename Allocator>
+auto Image<API, Allocator>::bindless() const -> int32_t {
+  return API::Image::bindless(this->m_handle);
+}
+
 template <typename API, typename Allocator>
 auto Image<API, Allocator>::layer(size_t index) -> Image<API, Allocator> {
   auto layer_handle = API::Image::layer(this->m_handle, index);
@@ -9,7 +9,7 @@ class Memory {
   explicit Memory();
   explicit Memory(int gpu, size_t size);
   explicit Memory(int gpu, HeapType type, size_t size);
-  explicit Memory(const Memory<API>& parent, size_t offset);
+  explicit Memory(const Memory<API, Allocator>& parent, size_t offset);
   explicit Memory(Memory&& mv);
   Memory(const Memory& cpy) = delete;
   ~Memory();
@@ -51,7 +51,8 @@ Memory<API, Allocator>::Memory(int gpu, HeapType type, size_t size) {
 }
 
 template <typename API, typename Allocator>
-Memory<API, Allocator>::Memory(const Memory<API>& parent, size_t offset) {
+Memory<API, Allocator>::Memory(const Memory<API, Allocator>& parent,
+                               size_t offset) {
   this->m_gpu = parent.m_gpu;
   this->m_handle = API::Memory::offset(parent.m_handle, offset);
 }
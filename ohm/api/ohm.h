@@ -3,6 +3,7 @@
 #include "commands.h"
 #include "descriptor.h"
 #include "event.h"
+#include "graph.h"
 #include "image.h"
 #include "memory.h"
 #include "pipeline.h"
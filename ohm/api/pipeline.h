@@ -1,8 +1,14 @@
 #pragma once
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 #include "descriptor.h"
+#include "ohm/io/archive.h"
 #include "ohm/io/shader.h"
 #include "render_pass.h"
 namespace ohm {
@@ -30,7 +36,11 @@ struct Viewport {
   }
 };
 
+/** Pipelines take their stages from the first of shader, spirv, inline_files
+ * and file_name that is set. All but inline_files skip compilation.
+ */
 struct PipelineInfo {
+  // Path to a compiled .osh, like those made at build time by ohm_add_shaders.
   std::string file_name;
   std::vector<Viewport> viewports;
   bool stencil_test;
@@ -40,6 +50,15 @@ struct PipelineInfo {
   // name : shader contents.
   std::vector<std::pair<std::string, std::string>> inline_files;
 
+  // name : SPIR-V words. Names give the stage types, like inline_files.
+  std::vector<std::pair<std::string, std::vector<uint32_t>>> spirv;
+
+  // Already loaded stages, shared by every pipeline made from this info.
+  std::shared_ptr<const io::Shader> shader;
+
+  // Specialization constant ID : value bits, for every stage declaring it.
+  std::map<uint32_t, uint64_t> specialization;
+
   PipelineInfo() {
     this->topology = Topology::Triangle;
     this->depth_test = false;
@@ -60,6 +79,33 @@ struct PipelineInfo {
     this->stencil_test = false;
   }
 
+  PipelineInfo(
+      std::vector<std::pair<std::string, std::vector<uint32_t>>> spirv) {
+    this->spirv = spirv;
+    this->topology = Topology::Triangle;
+    this->depth_test = false;
+    this->stencil_test = false;
+  }
+
+  PipelineInfo(std::shared_ptr<const io::Shader> shader) {
+    this->shader = shader;
+    this->topology = Topology::Triangle;
+    this->depth_test = false;
+    this->stencil_test = false;
+  }
+
+  /** Constructor to take a shader by name from a mapped archive. Its stages
+   * are copied out, so the archive needn't outlive the info. Leaves shader
+   * unset if the archive has no such shader.
+   */
+  PipelineInfo(const io::ShaderArchive& archive, std::string_view name) {
+    auto loaded = std::make_shared<io::Shader>();
+    if (loaded->load(archive.find(name))) this->shader = std::move(loaded);
+    this->topology = Topology::Triangle;
+    this->depth_test = false;
+    this->stencil_test = false;
+  }
+
   PipelineInfo(std::string_view file, Viewport viewport) {
     this->file_name = file;
     this->viewports.push_back(viewport);
@@ -67,6 +113,21 @@ struct PipelineInfo {
     this->depth_test = false;
     this->stencil_test = false;
   }
+
+  /** Method to override a specialization constant's default. The value's type
+   * must match the constant's declared type, e.g. float for a GLSL float.
+   */
+  template <typename Type>
+  auto specialize(uint32_t id, Type value) -> void {
+    static_assert(std::is_arithmetic<Type>::value && sizeof(Type) <= 8,
+                  "Specialization constants are bools, ints or floats.");
+    auto bits = uint64_t(0);
+    if (std::is_same<Type, bool>::value)
+      bits = value ? 1 : 0;
+    else
+      std::memcpy(&bits, &value, sizeof(Type));
+    this->specialization[id] = bits;
+  }
 };
 
 template <typename API, typename Allocator>
@@ -90,7 +151,71 @@ class Pipeline {
   auto descriptor() const -> Descriptor<API>;
   auto handle() const -> int32_t;
 
+  /** Method to make a descriptor for a single frame. Rather than being freed
+   * on destruction, its set is released along with every other transient one
+   * once retired, so it must not be used past that.
+   */
+  auto transientDescriptor() const -> Descriptor<API>;
+
+  /** Method to retire every transient descriptor made since the last call,
+   * once the commands' last submit has finished. Call it after submitting
+   * the frame that uses them; their sets are then reset together and reused.
+   */
+  template <typename Cmds>
+  auto retire(const Cmds& commands) const -> void;
+
+  /** Method to resolve a shader variable's name once, for binding by ID.
+   * @return The binding ID, or -1 if no variable has that name.
+   */
+  auto binding(std::string_view name) const -> int32_t;
+
+  /** Method to check, without blocking, whether a pipeline made by
+   * createAsync has finished building. Always true for other initialized
+   * pipelines, and false for ones without a handle.
+   */
+  auto ready() const -> bool;
+
+  /** Method to block until the pipeline has finished building, helping the
+   * job system in the meantime.
+   */
+  auto wait() const -> void;
+
+  /** Creates a pipeline shared with every other made by shared() from the
+   * same creation state, so its shaders are compiled and its pipeline and
+   * descriptor pool made only once. The pipeline lives until the last of them
+   * is destroyed.
+   */
+  static auto shared(int gpu, const PipelineInfo& info) -> Pipeline;
+
+  template <typename Allocator>
+  static auto shared(const RenderPass<API, Allocator>& rp,
+                     const PipelineInfo& info) -> Pipeline;
+
+  /** Creates a pipeline whose shaders are compiled and which is built on the
+   * job system, returning at once. Until ready() is true, skip recording work
+   * that uses it; descriptor() and destruction wait for it instead.
+   */
+  static auto createAsync(int gpu, const PipelineInfo& info) -> Pipeline;
+
+  template <typename Allocator>
+  static auto createAsync(const RenderPass<API, Allocator>& rp,
+                          const PipelineInfo& info) -> Pipeline;
+
+  /** Creates a batch of pipelines, compiling their shaders and building them
+   * concurrently on the job system. Pipelines are returned in the order of
+   * their infos.
+   */
+  static auto createMany(int gpu, const std::vector<PipelineInfo>& infos)
+      -> std::vector<Pipeline>;
+
+  template <typename Allocator>
+  static auto createMany(const RenderPass<API, Allocator>& rp,
+                         const std::vector<PipelineInfo>& infos)
+      -> std::vector<Pipeline>;
+
  private:
+  Pipeline(int gpu, int32_t rp_handle, int32_t handle,
+           const PipelineInfo& info);
   PipelineInfo m_info;
   int m_gpu;
   int32_t m_rp_handle;
@@ -122,6 +247,15 @@ Pipeline<API>::Pipeline(const RenderPass<API, Allocator>& rp,
   this->m_handle = API::Pipeline::create_from_rp(rp.handle(), info);
 }
 
+template <typename API>
+Pipeline<API>::Pipeline(int gpu, int32_t rp_handle, int32_t handle,
+                        const PipelineInfo& info) {
+  this->m_rp_handle = rp_handle;
+  this->m_gpu = gpu;
+  this->m_info = info;
+  this->m_handle = handle;
+}
+
 template <typename API>
 Pipeline<API>::Pipeline(Pipeline&& mv) {
   *this = std::move(mv);
@@ -171,4 +305,92 @@ template <typename API>
 auto Pipeline<API>::handle() const -> int32_t {
   return this->m_handle;
 }
-}  // namespace ohm
\ No newline at end of file
+
+template <typename API>
+auto Pipeline<API>::transientDescriptor() const -> Descriptor<API> {
+  auto handle = API::Pipeline::transient_descriptor(this->m_handle);
+  return Descriptor<API>(handle, this);
+}
+
+template <typename API>
+template <typename Cmds>
+auto Pipeline<API>::retire(const Cmds& commands) const -> void {
+  API::Pipeline::retire(this->m_handle, commands.handle());
+}
+
+template <typename API>
+auto Pipeline<API>::binding(std::string_view name) const -> int32_t {
+  return API::Pipeline::binding(this->m_handle, bindingHash(name));
+}
+
+template <typename API>
+auto Pipeline<API>::ready() const -> bool {
+  return API::Pipeline::ready(this->m_handle);
+}
+
+template <typename API>
+auto Pipeline<API>::wait() const -> void {
+  API::Pipeline::wait(this->m_handle);
+}
+
+template <typename API>
+auto Pipeline<API>::shared(int gpu, const PipelineInfo& info) -> Pipeline {
+  auto handle = API::Pipeline::create_shared(gpu, info);
+  return Pipeline(gpu, -1, handle, info);
+}
+
+template <typename API>
+template <typename Allocator>
+auto Pipeline<API>::shared(const RenderPass<API, Allocator>& rp,
+                           const PipelineInfo& info) -> Pipeline {
+  auto handle = API::Pipeline::create_shared_from_rp(rp.handle(), info);
+  return Pipeline(rp.gpu(), rp.handle(), handle, info);
+}
+
+template <typename API>
+auto Pipeline<API>::createAsync(int gpu, const PipelineInfo& info)
+    -> Pipeline {
+  auto handle = API::Pipeline::create_async(gpu, info);
+  return Pipeline(gpu, -1, handle, info);
+}
+
+template <typename API>
+template <typename Allocator>
+auto Pipeline<API>::createAsync(const RenderPass<API, Allocator>& rp,
+                                const PipelineInfo& info) -> Pipeline {
+  auto handle = API::Pipeline::create_async_from_rp(rp.handle(), info);
+  return Pipeline(rp.gpu(), rp.handle(), handle, info);
+}
+
+template <typename API>
+auto Pipeline<API>::createMany(int gpu, const std::vector<PipelineInfo>& infos)
+    -> std::vector<Pipeline> {
+  auto handles = std::vector<int32_t>(infos.size(), -1);
+  auto pipelines = std::vector<Pipeline>();
+
+  API::Pipeline::create_many(gpu, infos.data(), infos.size(), handles.data());
+  pipelines.reserve(infos.size());
+  for (auto index = 0u; index < infos.size(); index++) {
+    pipelines.emplace_back(Pipeline(gpu, -1, handles[index], infos[index]));
+  }
+  return pipelines;
+}
+
+template <typename API>
+template <typename Allocator>
+auto Pipeline<API>::createMany(const RenderPass<API, Allocator>& rp,
+                               const std::vector<PipelineInfo>& infos)
+    -> std::vector<Pipeline> {
+  auto handles = std::vector<int32_t>(infos.size(), -1);
+  auto pipelines = std::vector<Pipeline>();
+
+  API::Pipeline::create_many_from_rp(rp.handle(), infos.data(), infos.size(),
+                                     handles.data());
+  pipelines.reserve(infos.size());
+  for (auto index = 0u; index < infos.size(); index++) {
+    pipelines.emplace_back(
+        Pipeline(rp.gpu(), rp.handle(), handles[index], infos[index]));
+  }
+  return pipelines;
+}
+}  // namespace ohm
@@ -14,6 +14,25 @@ class System {
   static auto name() -> std::string;
   static auto setParameter(std::string_view param) -> void;
   static auto setDebugParameter(std::string_view param) -> void;
+
+  /** Sets the directory pipeline caches are loaded from on initialize() and
+   * saved to on shutdown(). Must be called before initialize(). Caches written
+   * by a different device or driver are ignored.
+   */
+  static auto setPipelineCache(std::string_view directory) -> void;
+
+  /** Writes every device's pipeline cache now, rather than at shutdown().
+   */
+  static auto savePipelineCache() -> void;
+
+  /** Turns on bindless mode: each device keeps one descriptor heap holding
+   * every image and array, which pipelines see as descriptor set 1 and which
+   * is bound along with their own set. Must be called before initialize().
+   * Devices without descriptor indexing, or whose update-after-bind limits
+   * are too small, keep working without a heap. Heaps are sized to fit those
+   * limits.
+   */
+  static auto setBindless(bool enable) -> void;
   static auto devices() -> std::vector<Gpu>;
   static auto shutdown() -> void;
 };
@@ -43,6 +62,21 @@ auto System<API>::setDebugParameter(std::string_view param) -> void {
   API::System::set_debug_parameter(param);
 }
 
+template <typename API>
+auto System<API>::setPipelineCache(std::string_view directory) -> void {
+  API::System::set_pipeline_cache(directory);
+}
+
+template <typename API>
+auto System<API>::savePipelineCache() -> void {
+  API::System::save_pipeline_cache();
+}
+
+template <typename API>
+auto System<API>::setBindless(bool enable) -> void {
+  API::System::set_bindless(enable);
+}
+
 template <typename API>
 auto System<API>::devices() -> std::vector<Gpu> {
   return API::System::devices();
@@ -52,5 +86,8 @@ auto System<API>::devices() -> std::vector<Gpu> {
 /** Required functions of API
  * System::name -> string
  * System::setParameter -> void
+ * System::set_pipeline_cache(directory) -> void
+ * System::save_pipeline_cache() -> void
+ * System::set_bindless(enable) -> void
  * System::devices -> vector<Gpu>
  */
\ No newline at end of file
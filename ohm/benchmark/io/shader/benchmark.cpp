@@ -1,7 +1,10 @@
 #include <fstream>
 #include <iostream>
+#include <map>
 #include <ostream>
+#include "ohm/io/archive.h"
 #include "ohm/io/shader.h"
+#include "ohm/io/shader_cache.h"
 
 #include <benchmark/benchmark.h>
 
@@ -48,6 +51,15 @@ auto bench_shader_creation(benchmark::State& state) {
   }
 }
 
+auto bench_shader_creation_uncached(benchmark::State& state) {
+  ohm::io::shaderCache().setEnabled(false);
+  while (state.KeepRunning()) {
+    auto shader = ohm::io::Shader(shaders);
+    benchmark::DoNotOptimize(shader);
+  }
+  ohm::io::shaderCache().setEnabled(true);
+}
+
 auto bench_shader_creation_from_file(benchmark::State& state) {
   while (state.KeepRunning()) {
     auto shader = ohm::io::Shader(shader_files);
@@ -55,7 +67,52 @@ auto bench_shader_creation_from_file(benchmark::State& state) {
   }
 }
 
+constexpr auto archived_shader_count = 64;
+const char* archive_file = "test_shaders.oar";
+
+auto osh_file(int index) -> std::string {
+  return "test_shader_" + std::to_string(index) + ".osh";
+}
+
+auto osh_name(int index) -> std::string {
+  return "test_shader_" + std::to_string(index);
+}
+
+auto bench_shader_load_from_files(benchmark::State& state) {
+  while (state.KeepRunning()) {
+    for (auto index = 0; index < archived_shader_count; index++) {
+      auto shader = ohm::io::Shader();
+      shader.load(osh_file(index));
+      benchmark::DoNotOptimize(shader);
+    }
+  }
+}
+
+auto bench_shader_load_from_archive(benchmark::State& state) {
+  while (state.KeepRunning()) {
+    auto archive = ohm::io::ShaderArchive(archive_file);
+    for (auto index = 0; index < archived_shader_count; index++) {
+      auto shader = ohm::io::Shader();
+      shader.load(archive.find(osh_name(index)));
+      benchmark::DoNotOptimize(shader);
+    }
+  }
+}
+
+auto write_archived_shaders() -> void {
+  auto shader = ohm::io::Shader(shaders);
+  auto archived = std::map<std::string, std::vector<ohm::io::Shader::Stage>>();
+  for (auto index = 0; index < archived_shader_count; index++) {
+    shader.save(osh_file(index));
+    archived[osh_name(index)] = shader.stages();
+  }
+  ohm::io::ShaderArchive::write(archive_file, archived);
+}
+
 BENCHMARK(bench_shader_creation);
+BENCHMARK(bench_shader_creation_uncached);
+BENCHMARK(bench_shader_load_from_files);
+BENCHMARK(bench_shader_load_from_archive);
 
 int main(int argc, char** argv) {
   std::ofstream stream("test_shader.comp.glsl");
@@ -63,6 +120,7 @@ int main(int argc, char** argv) {
     stream.write(test_compute_shader, sizeof(test_compute_shader));
     stream.close();
   }
+  write_archived_shaders();
 
   benchmark::Initialize(&argc, argv);
   if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
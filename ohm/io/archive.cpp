@@ -0,0 +1,171 @@
+#include "archive.h"
+#include "serialize.h"
+#include "shader_cache.h"
+#include <cstring>
+#include <utility>
+
+namespace ohm {
+namespace io {
+inline namespace v1 {
+constexpr auto osh_alignment = 16;
+
+struct ShaderArchive::Header {
+  uint64_t magic;
+  uint32_t version;
+  uint32_t count;
+  uint64_t index;
+  uint64_t buckets;
+  uint64_t size;
+};
+
+// Empty buckets have no shader, so a zero size marks them.
+struct ShaderArchive::Bucket {
+  uint64_t hash;
+  uint64_t name;
+  uint32_t name_size;
+  uint32_t padding;
+  uint64_t offset;
+  uint64_t size;
+};
+
+inline auto hash_name(std::string_view name) -> uint64_t {
+  return ShaderCache::hash(name.data(), name.size());
+}
+
+ShaderArchive::ShaderArchive() {}
+
+ShaderArchive::ShaderArchive(std::string_view path) { this->open(path); }
+
+ShaderArchive::ShaderArchive(ShaderArchive&& mv) {
+  this->m_file = std::move(mv.m_file);
+}
+
+auto ShaderArchive::operator=(ShaderArchive&& mv) -> ShaderArchive& {
+  this->m_file = std::move(mv.m_file);
+  return *this;
+}
+
+auto ShaderArchive::write(
+    std::string_view path,
+    const std::map<std::string, std::vector<Shader::Stage>>& shaders) -> bool {
+  // At most half full, so probes stay short.
+  auto buckets = size_t(1);
+  while (buckets < shaders.size() * 2) buckets *= 2;
+
+  auto out = Writer();
+  auto index = std::vector<Bucket>(buckets, Bucket());
+  auto header = Header();
+  header.magic = ShaderArchive::magic;
+  header.version = ShaderArchive::version;
+  header.count = static_cast<uint32_t>(shaders.size());
+  header.index = sizeof(Header);
+  header.buckets = buckets;
+
+  out.bytes.resize(sizeof(Header) + buckets * sizeof(Bucket), 0);
+  for (auto& shader : shaders) {
+    auto hash = hash_name(shader.first);
+    auto slot = hash & (buckets - 1);
+    while (index[slot].size != 0) slot = (slot + 1) & (buckets - 1);
+
+    auto& bucket = index[slot];
+    auto osh = Osh::encode(shader.second);
+    bucket.hash = hash;
+    bucket.name = out.bytes.size();
+    bucket.name_size = static_cast<uint32_t>(shader.first.size());
+    out.raw(shader.first.data(), shader.first.size());
+
+    out.align(osh_alignment);
+    bucket.offset = out.bytes.size();
+    bucket.size = osh.size();
+    out.raw(osh.data(), osh.size());
+  }
+
+  header.size = out.bytes.size();
+  std::memcpy(out.bytes.data(), &header, sizeof(Header));
+  std::memcpy(out.bytes.data() + sizeof(Header), index.data(),
+              index.size() * sizeof(Bucket));
+
+  return write_file(std::string(path), out.bytes);
+}
+
+auto ShaderArchive::open(std::string_view path) -> bool {
+  // Lookups land all over the file, so reading ahead only wastes I/O.
+  if (!this->m_file.open(path, Mapping::Access::Random)) return false;
+  if (!this->check()) {
+    this->close();
+    return false;
+  }
+  return true;
+}
+
+auto ShaderArchive::close() -> void { this->m_file.close(); }
+
+auto ShaderArchive::valid() const -> bool { return this->m_file.valid(); }
+
+auto ShaderArchive::count() const -> size_t {
+  if (!this->valid()) return 0;
+  return reinterpret_cast<const Header*>(this->m_file.data())->count;
+}
+
+auto ShaderArchive::find(std::string_view name) const -> Osh {
+  auto osh = Osh();
+  if (!this->valid()) return osh;
+
+  auto* data = this->m_file.data();
+  auto* header = reinterpret_cast<const Header*>(data);
+  auto* index = reinterpret_cast<const Bucket*>(data + header->index);
+  auto mask = header->buckets - 1;
+  auto hash = hash_name(name);
+
+  for (auto slot = hash & mask;; slot = (slot + 1) & mask) {
+    auto& bucket = index[slot];
+    if (bucket.size == 0) break;
+
+    auto stored = std::string_view(data + bucket.name, bucket.name_size);
+    if (bucket.hash == hash && stored == name) {
+      osh.open(data + bucket.offset, bucket.size);
+      break;
+    }
+  }
+  return osh;
+}
+
+/** Validates the header and index once, so lookups never need to. Each
+ * shader is still checked by Osh when found.
+ */
+auto ShaderArchive::check() const -> bool {
+  auto size = this->m_file.size();
+  auto inside = [size](uint64_t offset, uint64_t bytes) {
+    return offset <= size && bytes <= size - offset;
+  };
+
+  if (size < sizeof(Header)) return false;
+  auto* data = this->m_file.data();
+  auto* header = reinterpret_cast<const Header*>(data);
+  if (header->magic != ShaderArchive::magic) return false;
+  if (header->version != ShaderArchive::version) return false;
+  if (header->size != size) return false;
+  if (header->index % alignof(Bucket) != 0) return false;
+
+  // Power of two, and never full, so probing always reaches an empty bucket.
+  auto buckets = header->buckets;
+  if (buckets == 0 || (buckets & (buckets - 1)) != 0) return false;
+  if (header->count >= buckets) return false;
+  if (buckets > size / sizeof(Bucket)) return false;
+  if (!inside(header->index, buckets * sizeof(Bucket))) return false;
+
+  auto* index = reinterpret_cast<const Bucket*>(data + header->index);
+  auto used = uint64_t(0);
+  for (auto slot = uint64_t(0); slot < buckets; slot++) {
+    auto& bucket = index[slot];
+    if (bucket.size == 0) continue;
+    if (!inside(bucket.name, bucket.name_size)) return false;
+    if (!inside(bucket.offset, bucket.size)) return false;
+    if (bucket.offset % osh_alignment != 0) return false;
+    used++;
+  }
+  return used == header->count;
+}
+}  // namespace v1
+}  // namespace io
+}  // namespace ohm
@@ -0,0 +1,71 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "mapping.h"
+#include "osh.h"
+#include "shader.h"
+
+namespace ohm {
+namespace io {
+inline namespace v1 {
+/** Object to read many shaders packed into one file, so startup opens a
+ * single file instead of one per shader. The archive is mapped and looked up
+ * through a hashed index, so only the pages of the shaders actually used are
+ * ever read from disk.
+ *
+ * Layout, all offsets from the start of the file:
+ *  - Header: magic, version, shader count, index offset, bucket count, size.
+ *  - Index: open addressed buckets of name hash, name and .osh location.
+ *  - Blobs: names, then every shader as a 16 byte aligned .osh.
+ */
+class ShaderArchive {
+ public:
+  static constexpr uint64_t magic = 0x4843524148534f48;  // "OHSHARCH"
+  static constexpr uint32_t version = 1;
+
+  ShaderArchive();
+  explicit ShaderArchive(std::string_view path);
+  ShaderArchive(ShaderArchive&& mv);
+  ShaderArchive(const ShaderArchive& cpy) = delete;
+  ~ShaderArchive() = default;
+  auto operator=(ShaderArchive&& mv) -> ShaderArchive&;
+  auto operator=(const ShaderArchive& cpy) -> ShaderArchive& = delete;
+
+  /** Method to pack named shaders' stages into an archive file.
+   * @return Whether the file was written.
+   */
+  static auto write(
+      std::string_view path,
+      const std::map<std::string, std::vector<Shader::Stage>>& shaders)
+      -> bool;
+
+  /** Method to map an archive, releasing any archive mapped before.
+   * @return Whether the file exists and is a valid archive of this version.
+   */
+  auto open(std::string_view path) -> bool;
+
+  auto close() -> void;
+  auto valid() const -> bool;
+  auto count() const -> size_t;
+
+  /** Method to look up a shader by the name it was written with.
+   * @return A view of the shader, pointing into this archive, so it must not
+   * outlive it. Invalid if the archive has no such shader.
+   */
+  auto find(std::string_view name) const -> Osh;
+
+ private:
+  struct Header;
+  struct Bucket;
+
+  auto check() const -> bool;
+
+  Mapping m_file;
+};
+}  // namespace v1
+}  // namespace io
+}  // namespace ohm
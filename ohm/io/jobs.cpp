@@ -0,0 +1,129 @@
+#include "jobs.h"
+#include <algorithm>
+
+namespace ohm {
+namespace io {
+inline namespace v1 {
+// Index of the queue owned by the current thread, or -1 off the pool.
+static thread_local int worker_index = -1;
+
+JobSystem::JobSystem(unsigned workers) {
+  if (workers == 0) {
+    auto hardware = std::thread::hardware_concurrency();
+    workers = std::max(hardware, 2u) - 1;
+  }
+
+  this->m_pending = 0;
+  this->m_next = 0;
+  this->m_stop = false;
+
+  for (auto index = 0u; index < workers; index++) {
+    this->m_queues.push_back(std::make_unique<Queue>());
+  }
+  for (auto index = 0u; index < workers; index++) {
+    this->m_threads.emplace_back([this, index]() { this->run(index); });
+  }
+}
+
+JobSystem::~JobSystem() {
+  {
+    auto lock = std::unique_lock<std::mutex>(this->m_sleep_lock);
+    this->m_stop = true;
+  }
+  this->m_wake.notify_all();
+  for (auto& thread : this->m_threads) thread.join();
+}
+
+auto JobSystem::submit(Job job) -> void {
+  // Workers keep what they spawn local; everyone else spreads it around.
+  auto index = worker_index >= 0 ? static_cast<unsigned>(worker_index)
+                                  : this->m_next.fetch_add(1);
+  auto& queue = *this->m_queues[index % this->m_queues.size()];
+
+  // Counted before it's published, so a worker taking it right away can't
+  // bring the count below zero.
+  {
+    auto lock = std::unique_lock<std::mutex>(this->m_sleep_lock);
+    this->m_pending++;
+  }
+  {
+    auto lock = std::unique_lock<std::mutex>(queue.lock);
+    queue.jobs.push_back(std::move(job));
+  }
+  this->m_wake.notify_one();
+}
+
+auto JobSystem::parallelFor(size_t count,
+                            const std::function<void(size_t)>& function)
+    -> void {
+  auto remaining = std::make_shared<std::atomic<size_t>>(count);
+  for (auto index = size_t(0); index < count; index++) {
+    this->submit([&function, remaining, index]() {
+      function(index);
+      remaining->fetch_sub(1, std::memory_order_release);
+    });
+  }
+
+  while (remaining->load(std::memory_order_acquire) != 0) {
+    if (!this->help()) std::this_thread::yield();
+  }
+}
+
+auto JobSystem::help() -> bool {
+  auto job = Job();
+  auto start = worker_index >= 0 ? static_cast<unsigned>(worker_index) : 0u;
+  if (!this->take(start, job)) return false;
+
+  job();
+  return true;
+}
+
+auto JobSystem::workers() const -> unsigned {
+  return static_cast<unsigned>(this->m_threads.size());
+}
+
+auto JobSystem::run(unsigned index) -> void {
+  worker_index = static_cast<int>(index);
+  while (true) {
+    auto job = Job();
+    if (this->take(index, job)) {
+      job();
+      continue;
+    }
+
+    auto lock = std::unique_lock<std::mutex>(this->m_sleep_lock);
+    this->m_wake.wait(lock,
+                      [this]() { return this->m_stop || this->m_pending > 0; });
+    if (this->m_stop) return;
+  }
+}
+
+auto JobSystem::take(unsigned index, Job& job) -> bool {
+  const auto count = static_cast<unsigned>(this->m_queues.size());
+
+  // Own queue first, from the back, then steal the oldest work of the others.
+  for (auto offset = 0u; offset < count; offset++) {
+    auto& queue = *this->m_queues[(index + offset) % count];
+    auto lock = std::unique_lock<std::mutex>(queue.lock);
+    if (queue.jobs.empty()) continue;
+
+    if (offset == 0) {
+      job = std::move(queue.jobs.back());
+      queue.jobs.pop_back();
+    } else {
+      job = std::move(queue.jobs.front());
+      queue.jobs.pop_front();
+    }
+    this->m_pending--;
+    return true;
+  }
+  return false;
+}
+
+auto jobs() -> JobSystem& {
+  static JobSystem system;
+  return system;
+}
+}  // namespace v1
+}  // namespace io
+}  // namespace ohm
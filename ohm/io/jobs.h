@@ -0,0 +1,93 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ohm {
+namespace io {
+inline namespace v1 {
+using Job = std::function<void()>;
+
+/** Object to run jobs on a pool of worker threads. Every worker owns a queue,
+ * pops its own work from the back and steals from the front of the others'
+ * when it runs dry. Threads waiting on a batch run jobs themselves instead of
+ * blocking, so nesting batches inside jobs can't deadlock the pool.
+ */
+class JobSystem {
+ public:
+  /** Constructor.
+   * @param workers The amount of worker threads. 0 uses one less than the
+   * amount of hardware threads, since the caller helps while waiting.
+   */
+  explicit JobSystem(unsigned workers = 0);
+  JobSystem(const JobSystem& cpy) = delete;
+  ~JobSystem();
+  auto operator=(const JobSystem& cpy) -> JobSystem& = delete;
+
+  /** Method to queue a job to run on any worker.
+   */
+  auto submit(Job job) -> void;
+
+  /** Method to queue a function and get a future of its result.
+   */
+  template <typename Function>
+  auto async(Function function) -> std::future<std::invoke_result_t<Function>>;
+
+  /** Method to call a function for every index in [0, count) across the pool,
+   * returning once all of them are done.
+   */
+  auto parallelFor(size_t count, const std::function<void(size_t)>& function)
+      -> void;
+
+  /** Method to run one queued job on the calling thread, if there is one.
+   * @return Whether a job was run.
+   */
+  auto help() -> bool;
+
+  auto workers() const -> unsigned;
+
+ private:
+  struct Queue {
+    std::mutex lock;
+    std::deque<Job> jobs;
+  };
+
+  auto run(unsigned index) -> void;
+  auto take(unsigned index, Job& job) -> bool;
+
+  std::vector<std::unique_ptr<Queue>> m_queues;
+  std::vector<std::thread> m_threads;
+  std::mutex m_sleep_lock;
+  std::condition_variable m_wake;
+  std::atomic<size_t> m_pending;
+  std::atomic<unsigned> m_next;
+  bool m_stop;
+};
+
+/** Method to retrieve the process-wide job system, created on first use.
+ */
+auto jobs() -> JobSystem&;
+
+template <typename Function>
+auto JobSystem::async(Function function)
+    -> std::future<std::invoke_result_t<Function>> {
+  using Result = std::invoke_result_t<Function>;
+
+  // std::function needs a copyable target, so the task is shared.
+  auto task =
+      std::make_shared<std::packaged_task<Result()>>(std::move(function));
+  auto future = task->get_future();
+  this->submit([task]() { (*task)(); });
+  return future;
+}
+}  // namespace v1
+}  // namespace io
+}  // namespace ohm
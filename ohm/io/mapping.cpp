@@ -0,0 +1,105 @@
+#include "mapping.h"
+#include <fstream>
+#include <string>
+#include <utility>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ohm {
+namespace io {
+inline namespace v1 {
+Mapping::Mapping() {
+  this->m_data = nullptr;
+  this->m_size = 0;
+  this->m_mapped = false;
+}
+
+Mapping::Mapping(Mapping&& mv) : Mapping() { *this = std::move(mv); }
+
+Mapping::~Mapping() { this->close(); }
+
+auto Mapping::operator=(Mapping&& mv) -> Mapping& {
+  this->close();
+  this->m_data = mv.m_data;
+  this->m_size = mv.m_size;
+  this->m_buffer = std::move(mv.m_buffer);
+  this->m_mapped = mv.m_mapped;
+
+  mv.m_data = nullptr;
+  mv.m_size = 0;
+  mv.m_mapped = false;
+  return *this;
+}
+
+auto Mapping::open(std::string_view path, Access access) -> bool {
+  auto file = std::string(path);
+  this->close();
+
+#ifdef __linux__
+  auto fd = ::open(file.c_str(), O_RDONLY);
+  if (fd < 0) return false;
+
+  struct stat info = {};
+  if (::fstat(fd, &info) != 0 || info.st_size <= 0) {
+    ::close(fd);
+    return false;
+  }
+
+  auto size = static_cast<size_t>(info.st_size);
+  auto* data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (data == MAP_FAILED) return false;
+
+  auto advice = access == Access::Random ? MADV_RANDOM : MADV_SEQUENTIAL;
+  ::madvise(data, size, advice);
+
+  this->m_data = static_cast<const char*>(data);
+  this->m_size = size;
+  this->m_mapped = true;
+#else
+  auto stream = std::ifstream(file, std::ios::binary | std::ios::ate);
+  if (!stream) return false;
+
+  auto size = static_cast<size_t>(stream.tellg());
+  if (size == 0) return false;
+
+  this->m_buffer.resize((size + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+  stream.seekg(0, std::ios::beg);
+  if (!stream.read(reinterpret_cast<char*>(this->m_buffer.data()), size)) {
+    this->m_buffer.clear();
+    return false;
+  }
+
+  this->m_data = reinterpret_cast<const char*>(this->m_buffer.data());
+  this->m_size = size;
+  (void)access;
+#endif
+  return true;
+}
+
+auto Mapping::close() -> void {
+#ifdef __linux__
+  if (this->m_mapped) {
+    ::munmap(const_cast<char*>(this->m_data), this->m_size);
+  }
+#endif
+
+  this->m_buffer.clear();
+  this->m_data = nullptr;
+  this->m_size = 0;
+  this->m_mapped = false;
+}
+
+auto Mapping::valid() const -> bool { return this->m_data != nullptr; }
+
+auto Mapping::data() const -> const char* { return this->m_data; }
+
+auto Mapping::size() const -> size_t { return this->m_size; }
+}  // namespace v1
+}  // namespace io
+}  // namespace ohm
@@ -0,0 +1,48 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace ohm {
+namespace io {
+inline namespace v1 {
+/** Object to map a file read-only into memory. Pages are only read from disk
+ * when first touched. Where mapping isn't available, the file is read into an
+ * 8 byte aligned buffer instead.
+ */
+class Mapping {
+ public:
+  /** How the mapping will be read, so the OS can pick its read-ahead.
+   */
+  enum class Access : int {
+    Sequential,
+    Random,
+  };
+
+  Mapping();
+  Mapping(Mapping&& mv);
+  Mapping(const Mapping& cpy) = delete;
+  ~Mapping();
+  auto operator=(Mapping&& mv) -> Mapping&;
+  auto operator=(const Mapping& cpy) -> Mapping& = delete;
+
+  /** Method to map a file, releasing any file mapped before.
+   * @return Whether the file exists and isn't empty.
+   */
+  auto open(std::string_view path, Access access = Access::Sequential) -> bool;
+
+  auto close() -> void;
+  auto valid() const -> bool;
+  auto data() const -> const char*;
+  auto size() const -> size_t;
+
+ private:
+  const char* m_data;
+  size_t m_size;
+  std::vector<uint64_t> m_buffer;
+  bool m_mapped;
+};
+}  // namespace v1
+}  // namespace io
+}  // namespace ohm
@@ -0,0 +1,214 @@
+#include "osh.h"
+#include "serialize.h"
+#include "ohm/api/exception.h"
+#include <cstring>
+#include <utility>
+
+namespace ohm {
+namespace io {
+inline namespace v1 {
+constexpr auto spirv_alignment = 16;
+
+struct Osh::Header {
+  uint64_t magic;
+  uint32_t version;
+  uint32_t count;
+  uint64_t table;
+  uint64_t size;
+};
+
+struct Osh::Entry {
+  int32_t type;
+  uint32_t name_size;
+  uint64_t name;
+  uint64_t spirv;
+  uint64_t words;
+  uint64_t reflection;
+  uint64_t reflection_size;
+  uint32_t workgroup[3];
+  uint32_t padding;
+};
+
+Osh::Osh() {
+  this->m_data = nullptr;
+  this->m_size = 0;
+}
+
+Osh::Osh(std::string_view path) : Osh() { this->open(path); }
+
+Osh::Osh(Osh&& mv) : Osh() { *this = std::move(mv); }
+
+Osh::~Osh() { this->close(); }
+
+auto Osh::operator=(Osh&& mv) -> Osh& {
+  // The mapped pages and any fallback buffer stay put when moved.
+  this->m_file = std::move(mv.m_file);
+  this->m_data = mv.m_data;
+  this->m_size = mv.m_size;
+
+  mv.m_data = nullptr;
+  mv.m_size = 0;
+  return *this;
+}
+
+auto Osh::encode(const std::vector<Shader::Stage>& stages)
+    -> std::vector<char> {
+  auto out = Writer();
+  auto entries = std::vector<Entry>(stages.size());
+  auto header = Header();
+  header.magic = Osh::magic;
+  header.version = Osh::version;
+  header.count = static_cast<uint32_t>(stages.size());
+  header.table = sizeof(Header);
+
+  out.bytes.resize(sizeof(Header) + entries.size() * sizeof(Entry), 0);
+  for (auto index = size_t(0); index < stages.size(); index++) {
+    auto& stage = stages[index];
+    auto& entry = entries[index];
+    auto reflection = Writer();
+    write_reflection(reflection, stage);
+
+    entry = Entry();
+    entry.type = static_cast<int32_t>(stage.type);
+    entry.name = out.bytes.size();
+    entry.name_size = static_cast<uint32_t>(stage.name.size());
+    out.raw(stage.name.data(), stage.name.size());
+
+    out.align(spirv_alignment);
+    entry.spirv = out.bytes.size();
+    entry.words = stage.spirv.size();
+    out.raw(stage.spirv.data(), stage.spirv.size() * sizeof(uint32_t));
+
+    entry.reflection = out.bytes.size();
+    entry.reflection_size = reflection.bytes.size();
+    out.raw(reflection.bytes.data(), reflection.bytes.size());
+
+    for (auto dim = 0u; dim < 3; dim++) {
+      entry.workgroup[dim] = stage.workgroup[dim];
+    }
+  }
+
+  header.size = out.bytes.size();
+  std::memcpy(out.bytes.data(), &header, sizeof(Header));
+  std::memcpy(out.bytes.data() + sizeof(Header), entries.data(),
+              entries.size() * sizeof(Entry));
+  return std::move(out.bytes);
+}
+
+auto Osh::write(std::string_view path, const std::vector<Shader::Stage>& stages)
+    -> bool {
+  return write_file(std::string(path), Osh::encode(stages));
+}
+
+auto Osh::open(std::string_view path) -> bool {
+  this->close();
+  if (!this->m_file.open(path)) return false;
+  return this->view(this->m_file.data(), this->m_file.size());
+}
+
+auto Osh::open(const char* data, size_t size) -> bool {
+  this->close();
+  return this->view(data, size);
+}
+
+auto Osh::close() -> void {
+  this->m_file.close();
+  this->m_data = nullptr;
+  this->m_size = 0;
+}
+
+auto Osh::valid() const -> bool { return this->m_data != nullptr; }
+
+auto Osh::count() const -> size_t {
+  if (!this->valid()) return 0;
+  return reinterpret_cast<const Header*>(this->m_data)->count;
+}
+
+auto Osh::type(size_t stage) const -> Shader::Type {
+  return static_cast<Shader::Type>(this->entry(stage).type);
+}
+
+auto Osh::name(size_t stage) const -> std::string_view {
+  auto& entry = this->entry(stage);
+  return {this->m_data + entry.name, entry.name_size};
+}
+
+auto Osh::workgroup(size_t stage) const -> std::array<uint32_t, 3> {
+  auto& entry = this->entry(stage);
+  return {entry.workgroup[0], entry.workgroup[1], entry.workgroup[2]};
+}
+
+auto Osh::spirv(size_t stage) const -> const uint32_t* {
+  auto& entry = this->entry(stage);
+  return reinterpret_cast<const uint32_t*>(this->m_data + entry.spirv);
+}
+
+auto Osh::words(size_t stage) const -> size_t {
+  return this->entry(stage).words;
+}
+
+auto Osh::stage(size_t stage, Shader::Stage& out) const -> bool {
+  auto& entry = this->entry(stage);
+  auto tmp = Shader::Stage();
+  auto* reflection = this->m_data + entry.reflection;
+  auto in = Reader{reflection, reflection + entry.reflection_size};
+
+  tmp.type = this->type(stage);
+  tmp.name = std::string(this->name(stage));
+  tmp.spirv.assign(this->spirv(stage), this->spirv(stage) + entry.words);
+  if (!read_reflection(in, tmp)) return false;
+
+  out = std::move(tmp);
+  return true;
+}
+
+auto Osh::entry(size_t stage) const -> const Entry& {
+  OhmAssert(stage >= this->count(), "Accessing a stage the .osh doesn't have.");
+  auto* header = reinterpret_cast<const Header*>(this->m_data);
+  auto* table = reinterpret_cast<const Entry*>(this->m_data + header->table);
+  return table[stage];
+}
+
+auto Osh::view(const char* data, size_t size) -> bool {
+  this->m_data = data;
+  this->m_size = size;
+
+  if (!this->check()) {
+    this->close();
+    return false;
+  }
+  return true;
+}
+
+/** Validates everything the accessors trust once, so they never need to.
+ */
+auto Osh::check() const -> bool {
+  auto inside = [this](uint64_t offset, uint64_t size) {
+    return offset <= this->m_size && size <= this->m_size - offset;
+  };
+
+  if (this->m_size < sizeof(Header)) return false;
+  if (reinterpret_cast<uintptr_t>(this->m_data) % alignof(Header) != 0)
+    return false;
+  auto* header = reinterpret_cast<const Header*>(this->m_data);
+  if (header->magic != Osh::magic) return false;
+  if (header->version != Osh::version) return false;
+  if (header->size != this->m_size) return false;
+  if (header->table % alignof(Entry) != 0) return false;
+  if (!inside(header->table, uint64_t(header->count) * sizeof(Entry)))
+    return false;
+
+  auto* table = reinterpret_cast<const Entry*>(this->m_data + header->table);
+  for (auto index = 0u; index < header->count; index++) {
+    auto& entry = table[index];
+    if (!inside(entry.name, entry.name_size)) return false;
+    if (!inside(entry.reflection, entry.reflection_size)) return false;
+    if (entry.spirv % alignof(uint32_t) != 0) return false;
+    if (entry.words > this->m_size / sizeof(uint32_t)) return false;
+    if (!inside(entry.spirv, entry.words * sizeof(uint32_t))) return false;
+  }
+  return true;
+}
+}  // namespace v1
+}  // namespace io
+}  // namespace ohm
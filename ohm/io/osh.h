@@ -0,0 +1,93 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "mapping.h"
+#include "shader.h"
+
+namespace ohm {
+namespace io {
+inline namespace v1 {
+/** Object to read an .osh shader container in place. The file is mapped into
+ * memory and checked once when opened; after that, every stage's name,
+ * SPIR-V and workgroup size are pointers into the mapping, and its reflection
+ * is stored pre-serialized, so nothing is parsed or copied until a
+ * Shader::Stage is asked for.
+ *
+ * Layout, all offsets from the start of the file:
+ *  - Header: magic, version, stage count, stage table offset, file size.
+ *  - Stage table: per stage its type, workgroup size, and the offset and size
+ *    of its name, SPIR-V and reflection.
+ *  - Blobs: names, 16 byte aligned SPIR-V words, and reflection tables.
+ */
+class Osh {
+ public:
+  static constexpr uint64_t magic = 0x6F686D79676F64;  // "ohmygod"
+  static constexpr uint32_t version = 2;
+
+  Osh();
+  explicit Osh(std::string_view path);
+  Osh(Osh&& mv);
+  Osh(const Osh& cpy) = delete;
+  ~Osh();
+  auto operator=(Osh&& mv) -> Osh&;
+  auto operator=(const Osh& cpy) -> Osh& = delete;
+
+  /** Method to lay stages out as the bytes of an .osh file.
+   */
+  static auto encode(const std::vector<Shader::Stage>& stages)
+      -> std::vector<char>;
+
+  /** Method to write stages to an .osh file.
+   * @return Whether the file was written.
+   */
+  static auto write(std::string_view path,
+                    const std::vector<Shader::Stage>& stages) -> bool;
+
+  /** Method to map an .osh file, releasing any file mapped before.
+   * @return Whether the file exists and is a valid container of this version.
+   */
+  auto open(std::string_view path) -> bool;
+
+  /** Method to read an .osh held in memory owned elsewhere, like a shader
+   * archive. The memory must be 8 byte aligned and outlive this object.
+   * @return Whether the bytes are a valid container of this version.
+   */
+  auto open(const char* data, size_t size) -> bool;
+
+  auto close() -> void;
+  auto valid() const -> bool;
+  auto count() const -> size_t;
+  auto type(size_t stage) const -> Shader::Type;
+  auto name(size_t stage) const -> std::string_view;
+  auto workgroup(size_t stage) const -> std::array<uint32_t, 3>;
+
+  /** Method to retrieve a stage's SPIR-V, pointing into the mapped file.
+   * Valid until this object is closed.
+   */
+  auto spirv(size_t stage) const -> const uint32_t*;
+  auto words(size_t stage) const -> size_t;
+
+  /** Method to copy a stage out of the file, decoding its stored reflection.
+   * @return Whether the reflection could be decoded.
+   */
+  auto stage(size_t stage, Shader::Stage& out) const -> bool;
+
+ private:
+  struct Header;
+  struct Entry;
+
+  auto view(const char* data, size_t size) -> bool;
+  auto entry(size_t stage) const -> const Entry&;
+  auto check() const -> bool;
+
+  Mapping m_file;
+  const char* m_data;
+  size_t m_size;
+};
+}  // namespace v1
+}  // namespace io
+}  // namespace ohm
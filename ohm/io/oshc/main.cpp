@@ -0,0 +1,69 @@
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+#include "ohm/io/shader.h"
+
+/** oshc: compiles GLSL stages into one .osh ahead of time, so shipped binaries
+ * only ever load the result.
+ *
+ *   oshc -o <output.osh> <stage files...>
+ *
+ * Each stage's type comes from its file name (.vert, .frag, .comp, ...), the
+ * same as when compiled at runtime.
+ */
+static auto usage() -> int {
+  std::cerr << "usage: oshc -o <output.osh> <stage files...>" << std::endl;
+  return 1;
+}
+
+static auto file_name(const std::string& path) -> std::string {
+  auto slash = path.find_last_of("/\\");
+  return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+auto main(int argc, char* argv[]) -> int {
+  auto output = std::string();
+  auto inputs = std::vector<std::string>();
+
+  for (auto index = 1; index < argc; index++) {
+    auto arg = std::string(argv[index]);
+    if (arg == "-o" && index + 1 < argc)
+      output = argv[++index];
+    else if (!arg.empty() && arg[0] == '-')
+      return usage();
+    else
+      inputs.push_back(arg);
+  }
+  if (output.empty() || inputs.empty()) return usage();
+
+  // Stages are named by file name only, so outputs don't depend on where the
+  // sources were built from.
+  auto sources = std::vector<std::pair<std::string, std::string>>();
+  for (auto& input : inputs) {
+    auto stream = std::ifstream(input);
+    if (!stream) {
+      std::cerr << "oshc: can't read " << input << std::endl;
+      return 1;
+    }
+    sources.push_back({file_name(input),
+                       std::string(std::istreambuf_iterator<char>(stream),
+                                   std::istreambuf_iterator<char>())});
+  }
+
+  auto shader = ohm::io::Shader(sources);
+  for (auto& stage : shader.stages()) {
+    if (stage.spirv.empty()) {
+      std::cerr << "oshc: failed to compile " << stage.name << std::endl;
+      return 1;
+    }
+  }
+
+  if (!shader.save(output)) {
+    std::cerr << "oshc: can't write " << output << std::endl;
+    return 1;
+  }
+  return 0;
+}
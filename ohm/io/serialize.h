@@ -0,0 +1,195 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+#include "shader.h"
+
+// Internal to ohm: the byte layout shared by .osh files and shader cache
+// entries. Native endianness, since both are written and read on one machine.
+namespace ohm {
+namespace io {
+inline namespace v1 {
+/** Appends plain values and strings to a byte buffer.
+ */
+struct Writer {
+  std::vector<char> bytes;
+
+  template <typename Type>
+  auto value(Type value) -> void {
+    auto* ptr = reinterpret_cast<const char*>(&value);
+    this->bytes.insert(this->bytes.end(), ptr, ptr + sizeof(Type));
+  }
+
+  auto string(const std::string& str) -> void {
+    this->value<uint32_t>(str.size());
+    this->bytes.insert(this->bytes.end(), str.begin(), str.end());
+  }
+
+  auto raw(const void* data, size_t size) -> void {
+    auto* ptr = static_cast<const char*>(data);
+    this->bytes.insert(this->bytes.end(), ptr, ptr + size);
+  }
+
+  /** Pads with zeroes up to a multiple of alignment.
+   */
+  auto align(size_t alignment) -> void {
+    auto size = (this->bytes.size() + alignment - 1) / alignment * alignment;
+    this->bytes.resize(size, 0);
+  }
+};
+
+/** Writes a whole file aside and renames it into place, so readers, mapped
+ * ones included, never see a partial file and a crash never leaves one
+ * behind. The scratch file is per thread, since threads may write one path.
+ */
+inline auto write_file(const std::string& path, const std::vector<char>& bytes)
+    -> bool {
+  auto thread = std::hash<std::thread::id>()(std::this_thread::get_id());
+  auto scratch = path + "." + std::to_string(thread) + ".tmp";
+  {
+    auto stream = std::ofstream(scratch, std::ios::binary | std::ios::trunc);
+    if (!stream) return false;
+    stream.write(bytes.data(), bytes.size());
+    if (!stream) return false;
+  }
+  return std::rename(scratch.c_str(), path.c_str()) == 0;
+}
+
+/** Reads back what a Writer wrote, failing instead of reading past the end.
+ */
+struct Reader {
+  const char* ptr;
+  const char* end;
+  bool valid = true;
+
+  template <typename Type>
+  auto value() -> Type {
+    auto value = Type();
+    if (this->end - this->ptr < static_cast<ptrdiff_t>(sizeof(Type))) {
+      this->valid = false;
+      return value;
+    }
+    std::memcpy(&value, this->ptr, sizeof(Type));
+    this->ptr += sizeof(Type);
+    return value;
+  }
+
+  auto string() -> std::string {
+    auto size = this->value<uint32_t>();
+    if (this->end - this->ptr < static_cast<ptrdiff_t>(size)) {
+      this->valid = false;
+      return {};
+    }
+    auto str = std::string(this->ptr, size);
+    this->ptr += size;
+    return str;
+  }
+};
+
+inline auto write(Writer& out,
+                  const std::vector<Shader::Stage::Attribute>& list) -> void {
+  out.value<uint32_t>(list.size());
+  for (auto& attribute : list) {
+    out.string(attribute.name);
+    out.value<int32_t>(static_cast<int32_t>(attribute.type));
+    out.value<uint64_t>(attribute.location);
+  }
+}
+
+inline auto read(Reader& in, std::vector<Shader::Stage::Attribute>& list)
+    -> void {
+  auto count = in.value<uint32_t>();
+  for (auto index = 0u; index < count && in.valid; index++) {
+    auto attribute = Shader::Stage::Attribute();
+    attribute.name = in.string();
+    attribute.type =
+        static_cast<Shader::Stage::Attribute::Type>(in.value<int32_t>());
+    attribute.location = in.value<uint64_t>();
+    list.push_back(attribute);
+  }
+}
+
+/** Writes a stage's reflection tables: everything but its name, type and
+ * SPIR-V.
+ */
+inline auto write_reflection(Writer& out, const Shader::Stage& stage) -> void {
+  out.value<uint32_t>(stage.variables.size());
+  for (auto& variable : stage.variables) {
+    out.string(variable.first);
+    out.value<uint64_t>(variable.second.set);
+    out.value<uint64_t>(variable.second.binding);
+    out.value<uint64_t>(variable.second.size);
+    out.value<int32_t>(static_cast<int32_t>(variable.second.type));
+  }
+
+  write(out, stage.in_attributes);
+  write(out, stage.out_attributes);
+
+  out.value<uint32_t>(stage.push_constants.size());
+  for (auto& push_constant : stage.push_constants) {
+    out.string(push_constant.name);
+    out.value<uint64_t>(push_constant.offset);
+    out.value<uint64_t>(push_constant.size);
+  }
+
+  for (auto size : stage.workgroup) out.value<uint32_t>(size);
+
+  out.value<uint32_t>(stage.spec_constants.size());
+  for (auto& constant : stage.spec_constants) {
+    out.string(constant.name);
+    out.value<uint32_t>(constant.id);
+    out.value<uint64_t>(constant.size);
+    out.value<int32_t>(static_cast<int32_t>(constant.type));
+    out.value<uint64_t>(constant.value);
+  }
+}
+
+inline auto read_reflection(Reader& in, Shader::Stage& stage) -> bool {
+  auto count = in.value<uint32_t>();
+  for (auto index = 0u; index < count && in.valid; index++) {
+    auto name = in.string();
+    auto variable = Shader::Stage::Variable();
+    variable.set = in.value<uint64_t>();
+    variable.binding = in.value<uint64_t>();
+    variable.size = in.value<uint64_t>();
+    variable.type =
+        static_cast<Shader::Stage::Variable::Type>(in.value<int32_t>());
+    stage.variables[name] = variable;
+  }
+
+  read(in, stage.in_attributes);
+  read(in, stage.out_attributes);
+
+  count = in.value<uint32_t>();
+  for (auto index = 0u; index < count && in.valid; index++) {
+    auto push_constant = Shader::Stage::PushConstant();
+    push_constant.name = in.string();
+    push_constant.offset = in.value<uint64_t>();
+    push_constant.size = in.value<uint64_t>();
+    stage.push_constants.push_back(push_constant);
+  }
+
+  for (auto& size : stage.workgroup) size = in.value<uint32_t>();
+
+  count = in.value<uint32_t>();
+  for (auto index = 0u; index < count && in.valid; index++) {
+    auto constant = Shader::Stage::SpecConstant();
+    constant.name = in.string();
+    constant.id = in.value<uint32_t>();
+    constant.size = in.value<uint64_t>();
+    constant.type =
+        static_cast<Shader::Stage::SpecConstant::Type>(in.value<int32_t>());
+    constant.value = in.value<uint64_t>();
+    stage.spec_constants.push_back(constant);
+  }
+  return in.valid;
+}
+}  // namespace v1
+}  // namespace io
+}  // namespace ohm
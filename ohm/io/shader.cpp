@@ -1,7 +1,14 @@
 #include "shader.h"
+#include "jobs.h"
+#include "osh.h"
+#include "shader_cache.h"
 #include "ohm/api/exception.h"
 #include <spirv_reflect.h>
 #include <shaderc/shaderc.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <map>
 #include <fstream>
 #include <iostream>
 #include <ostream>
@@ -11,7 +18,6 @@
 namespace ohm {
 namespace io {
 inline namespace v1 {
-constexpr auto osh_magic_number = 0x6F686D79676F64;
 constexpr auto target_spirv_version = shaderc_spirv_version_1_2;
 constexpr auto target_environment = shaderc_target_env_vulkan;
 constexpr auto target_env_version = shaderc_env_version_vulkan_1_1;
@@ -24,6 +30,46 @@ inline auto sanitize(std::string_view view) -> std::string {
   return std::string(view);
 }
 
+static auto emit_assembly = std::atomic<bool>(false);
+
+inline auto make_options(bool optimize) -> shaderc::CompileOptions {
+  auto options = shaderc::CompileOptions();
+  options.SetTargetEnvironment(target_environment, target_env_version);
+  options.SetTargetSpirv(target_spirv_version);
+  if (optimize)
+    options.SetOptimizationLevel(shaderc_optimization_level_performance);
+  return options;
+}
+
+/** Compilers and options are costly to set up, so every thread keeps one of
+ * each and reuses them for all of its compilations.
+ */
+inline auto compiler() -> const shaderc::Compiler& {
+  thread_local const auto compiler = shaderc::Compiler();
+  return compiler;
+}
+
+inline auto base_options(bool optimize) -> const shaderc::CompileOptions& {
+  thread_local const auto plain = make_options(false);
+  thread_local const auto optimized = make_options(true);
+  return optimize ? optimized : plain;
+}
+
+/** Hashes everything that decides a stage's compiled output, so equal keys
+ * can share one compilation.
+ */
+inline auto cache_key(Shader::Type type, std::string_view src,
+                      const std::vector<std::string>& macros, bool optimize)
+    -> uint64_t {
+  const int32_t config[] = {static_cast<int32_t>(type), target_spirv_version,
+                            target_environment, target_env_version, optimize};
+  auto key = ShaderCache::hash(config, sizeof(config));
+  for (auto& macro : macros) {
+    key = ShaderCache::hash(macro.c_str(), macro.size() + 1, key);
+  }
+  return ShaderCache::hash(src.data(), src.size(), key);
+}
+
 inline auto type_from_name(const std::string& type) -> Shader::Type {
   auto find = [](std::string_view a, std::string_view b) {
     return a.find(b) != std::string::npos;
@@ -135,13 +181,20 @@ struct Shader::ShaderData {
                                 SpvReflectShaderModule& module) -> void;
   inline auto reflect_io(Shader::Stage& stage, SpvReflectShaderModule& module)
       -> void;
-  inline auto preprocess(std::string_view name, shaderc_shader_kind kind,
-                         std::string_view src) -> std::string;
+  inline auto reflect_push_constants(Shader::Stage& stage,
+                                     SpvReflectShaderModule& module) -> void;
+  inline auto reflect_spec_constants(Shader::Stage& stage) -> void;
+  inline auto options(bool optimize) const -> shaderc::CompileOptions;
+  inline auto compile(std::string_view name, shaderc_shader_kind kind,
+                      std::string_view src, bool optimize = false)
+      -> std::vector<uint32_t>;
   inline auto assemblize(std::string_view name, shaderc_shader_kind kind,
                          std::string_view src, bool optimize = false)
       -> std::string;
-  inline auto assemble(shaderc_shader_kind kind, std::string_view src,
-                       bool optimize = false) -> std::vector<uint32_t>;
+  inline auto build(const std::string& name, std::string_view src)
+      -> Shader::Stage;
+  inline auto build(const std::string& name, const std::vector<uint32_t>& spirv)
+      -> Shader::Stage;
 };
 
 auto Shader::ShaderData::reflect(Shader::Stage& stage) -> void {
@@ -155,6 +208,12 @@ auto Shader::ShaderData::reflect(Shader::Stage& stage) -> void {
 
   this->reflect_variables(stage, module);
   this->reflect_io(stage, module);
+  this->reflect_push_constants(stage, module);
+  this->reflect_spec_constants(stage);
+  if (module.entry_point_count > 0) {
+    auto& size = module.entry_points[0].local_size;
+    stage.workgroup = {size.x, size.y, size.z};
+  }
   spvReflectDestroyShaderModule(&module);
   (void)result;
   (void)success;
@@ -201,6 +260,124 @@ auto Shader::ShaderData::reflect_io(Shader::Stage& stage,
   (void)success;
 }
 
+auto Shader::ShaderData::reflect_push_constants(
+    Shader::Stage& stage, SpvReflectShaderModule& module) -> void {
+  constexpr auto success = SPV_REFLECT_RESULT_SUCCESS;
+  auto count = 0u;
+  auto result = spvReflectEnumeratePushConstantBlocks(&module, &count, nullptr);
+  OhmAssert(result != success, "Failed to enumerate SPV. ");
+
+  auto blocks = std::vector<SpvReflectBlockVariable*>(count);
+  result = spvReflectEnumeratePushConstantBlocks(&module, &count, blocks.data());
+  OhmAssert(result != success, "Failed to enumerate SPV. ");
+
+  for (const auto* block : blocks) {
+    auto push_constant = Stage::PushConstant();
+    push_constant.name = block->name ? block->name : "";
+    push_constant.offset = block->offset;
+    push_constant.size = block->size;
+    stage.push_constants.push_back(push_constant);
+  }
+  (void)success;
+  (void)result;
+}
+
+/** SPIRV-Reflect doesn't report specialization constants, so they're read
+ * straight from the module's instructions.
+ */
+auto Shader::ShaderData::reflect_spec_constants(Shader::Stage& stage) -> void {
+  using Type = Shader::Stage::SpecConstant::Type;
+  constexpr auto header_words = 5u;
+  constexpr auto op_name = 5u;
+  constexpr auto op_type_bool = 20u;
+  constexpr auto op_type_int = 21u;
+  constexpr auto op_type_float = 22u;
+  constexpr auto op_spec_constant_true = 48u;
+  constexpr auto op_spec_constant_false = 49u;
+  constexpr auto op_spec_constant = 50u;
+  constexpr auto op_decorate = 71u;
+  constexpr auto decoration_spec_id = 1u;
+
+  struct Constant {
+    uint32_t result;
+    uint32_t type;
+    uint64_t value;
+  };
+
+  auto names = std::map<uint32_t, std::string>();
+  auto ids = std::map<uint32_t, uint32_t>();
+  auto types = std::map<uint32_t, std::pair<Type, size_t>>();
+  auto constants = std::vector<Constant>();
+
+  auto& words = stage.spirv;
+  auto index = static_cast<size_t>(header_words);
+  while (index < words.size()) {
+    auto count = words[index] >> 16;
+    auto op = words[index] & 0xFFFF;
+    if (count == 0 || index + count > words.size()) break;
+
+    auto* operand = &words[index + 1];
+    switch (op) {
+      case op_name: {
+        if (count < 3) break;
+        auto* str = reinterpret_cast<const char*>(operand + 1);
+        auto* end = str + (count - 2) * sizeof(uint32_t);
+        names[operand[0]] = std::string(str, std::find(str, end, '\0'));
+        break;
+      }
+      case op_decorate:
+        if (count >= 4 && operand[1] == decoration_spec_id)
+          ids[operand[0]] = operand[2];
+        break;
+      case op_type_bool:
+        if (count < 2) break;
+        types[operand[0]] = {Type::Bool, sizeof(uint32_t)};
+        break;
+      case op_type_int:
+        if (count < 4) break;
+        types[operand[0]] = {operand[2] ? Type::Int : Type::UInt,
+                             operand[1] / 8};
+        break;
+      case op_type_float:
+        if (count < 3) break;
+        types[operand[0]] = {Type::Float, operand[1] / 8};
+        break;
+      case op_spec_constant_true:
+      case op_spec_constant_false:
+        if (count < 3) break;
+        constants.push_back(
+            {operand[1], operand[0], op == op_spec_constant_true ? 1u : 0u});
+        break;
+      case op_spec_constant: {
+        if (count < 4) break;
+        auto high = count > 4 ? uint64_t(operand[3]) << 32 : 0;
+        constants.push_back({operand[1], operand[0], high | operand[2]});
+        break;
+      }
+      default:
+        break;
+    }
+    index += count;
+  }
+
+  for (auto& constant : constants) {
+    auto id = ids.find(constant.result);
+    auto type = types.find(constant.type);
+    if (id == ids.end() || type == types.end()) continue;
+
+    auto spec = Shader::Stage::SpecConstant();
+    spec.name = names[constant.result];
+    spec.id = id->second;
+    spec.type = type->second.first;
+    spec.size = type->second.second;
+    spec.value = constant.value;
+    stage.spec_constants.push_back(spec);
+  }
+
+  std::sort(stage.spec_constants.begin(), stage.spec_constants.end(),
+            [](auto& a, auto& b) { return a.id < b.id; });
+}
+
 auto Shader::ShaderData::reflect_variables(Shader::Stage& stage,
                                            SpvReflectShaderModule& module)
     -> void {
@@ -227,22 +404,30 @@ auto Shader::ShaderData::reflect_variables(Shader::Stage& stage,
   (void)success;
   (void)result;
 }
-auto Shader::ShaderData::preprocess(std::string_view name,
-                                    shaderc_shader_kind kind,
-                                    std::string_view src) -> std::string {
-  auto compiler = shaderc::Compiler();
-  auto options = shaderc::CompileOptions();
-
+auto Shader::ShaderData::options(bool optimize) const
+    -> shaderc::CompileOptions {
+  auto options = shaderc::CompileOptions(base_options(optimize));
   for (auto& macro : this->macros) options.AddMacroDefinition(macro);
+  return options;
+}
 
-  options.SetTargetEnvironment(target_environment, target_env_version);
-  options.SetTargetSpirv(target_spirv_version);
-  auto result =
-      compiler.PreprocessGlsl(src.begin(), kind, name.begin(), options);
+auto Shader::ShaderData::compile(std::string_view name,
+                                 shaderc_shader_kind kind,
+                                 std::string_view src, bool optimize)
+    -> std::vector<uint32_t> {
+  auto file = std::string(name);
+  auto run = [&](const shaderc::CompileOptions& options) {
+    return compiler().CompileGlslToSpv(src.data(), src.size(), kind,
+                                       file.c_str(), options);
+  };
+
+  // Only shaders with macros need options of their own.
+  auto result = this->macros.empty() ? run(base_options(optimize))
+                                     : run(this->options(optimize));
 
   OhmAssert(
       result.GetCompilationStatus() != shaderc_compilation_status_success,
-      + "Failed to preprocess shader." + std::string(result.GetErrorMessage()));
+      "Failed to compile shader. " + std::string(result.GetErrorMessage()));
 
   return {result.cbegin(), result.cend()};
 }
@@ -251,18 +436,9 @@ auto Shader::ShaderData::assemblize(std::string_view name,
                                     shaderc_shader_kind kind,
                                     std::string_view src, bool optimize)
     -> std::string {
-  auto compiler = shaderc::Compiler();
-  auto options = shaderc::CompileOptions();
-
-  for (auto& macro : this->macros) options.AddMacroDefinition(macro);
-
-  options.SetTargetEnvironment(target_environment, target_env_version);
-  options.SetTargetSpirv(target_spirv_version);
-  if (optimize)
-    options.SetOptimizationLevel(shaderc_optimization_level_performance);
-
-  auto result = compiler.CompileGlslToSpvAssembly(src.begin(), kind,
-                                                  name.begin(), options);
+  auto file = std::string(name);
+  auto result = compiler().CompileGlslToSpvAssembly(
+      src.data(), src.size(), kind, file.c_str(), this->options(optimize));
 
   OhmAssert(
       result.GetCompilationStatus() != shaderc_compilation_status_success,
@@ -271,24 +447,54 @@ auto Shader::ShaderData::assemblize(std::string_view name,
   return {result.cbegin(), result.cend()};
 }
 
-auto Shader::ShaderData::assemble(shaderc_shader_kind kind,
-                                  std::string_view src, bool optimize)
-    -> std::vector<uint32_t> {
-  auto compiler = shaderc::Compiler();
-  auto options = shaderc::CompileOptions();
-
-  for (auto& macro : this->macros) options.AddMacroDefinition(macro);
-
-  options.SetTargetEnvironment(target_environment, target_env_version);
-  options.SetTargetSpirv(target_spirv_version);
-  if (optimize)
-    options.SetOptimizationLevel(shaderc_optimization_level_performance);
-
-  auto result = compiler.AssembleToSpv(src.begin(), src.size(), options);
-
-  OhmAssert(result.GetCompilationStatus() != shaderc_compilation_status_success, "Failed to assemble shader. " + std::string(result.GetErrorMessage()));
+/** Compiles and reflects one stage. Only reads this object's options, so
+ * stages can be built from multiple threads at once.
+ */
+auto Shader::ShaderData::build(const std::string& name, std::string_view src)
+    -> Shader::Stage {
+  auto type = type_from_name(name);
+  auto kind = convert(type);
+  auto key = cache_key(type, src, this->macros, false);
+
+  auto stage = Shader::Stage();
+  auto debug = emit_assembly.load();
+  stage.name = name;
+  if (!debug && shaderCache().find(key, stage)) return stage;
+
+  stage.spirv = this->compile(name, kind, src);
+  stage.type = type;
+
+  // Release builds don't assert, so a failed compile is left without SPIR-V.
+  if (stage.spirv.empty()) return stage;
+  this->reflect(stage);
+
+  // Debug stages carry their text, so they stay out of the cache.
+  if (debug) stage.assembly = this->assemblize(name, kind, src);
+  if (!debug) shaderCache().insert(key, stage);
+  return stage;
+}
 
-  return {result.cbegin(), result.cend()};
+/** Reflects one precompiled stage, caching the result by the SPIR-V's hash.
+ */
+auto Shader::ShaderData::build(const std::string& name,
+                               const std::vector<uint32_t>& spirv)
+    -> Shader::Stage {
+  const int32_t config[] = {static_cast<int32_t>(type_from_name(name)),
+                            static_cast<int32_t>(spirv.size())};
+  auto key = ShaderCache::hash(config, sizeof(config));
+  key = ShaderCache::hash(spirv.data(), spirv.size() * sizeof(uint32_t), key);
+
+  auto stage = Shader::Stage();
+  stage.name = name;
+  if (shaderCache().find(key, stage)) return stage;
+
+  stage.spirv = spirv;
+  stage.type = type_from_name(name);
+  if (stage.spirv.empty()) return stage;
+
+  this->reflect(stage);
+  shaderCache().insert(key, stage);
+  return stage;
 }
 
 Shader::Shader() { this->data = std::make_shared<Shader::ShaderData>(); }
@@ -331,29 +537,35 @@ Shader::Shader(Shader&& mv) {
 Shader::Shader(
     const std::vector<std::pair<std::string, std::string>>& inline_files) {
   this->data = std::make_shared<Shader::ShaderData>();
+  this->data->stages.resize(inline_files.size());
 
-  for (auto& shdr : inline_files) {
-    auto& name = shdr.first;
-    auto& file = shdr.second;
-
-    auto type = type_from_name(name);
-    auto kind = convert(type);
+  auto build = [this, &inline_files](size_t index) {
+    auto& file = inline_files[index];
+    this->data->stages[index] = this->data->build(file.first, file.second);
+  };
 
-    auto preprocessed = this->data->preprocess(name, kind, file);
-    auto assembly = this->data->assemblize(name, kind, preprocessed);
+  // Stages are independent, so they compile concurrently into their own slot.
+  if (inline_files.size() == 1)
+    build(0);
+  else
+    jobs().parallelFor(inline_files.size(), build);
+}
 
-    auto stage = Shader::Stage();
-    stage.name = name;
-    stage.spirv = this->data->assemble(kind, assembly);
-    stage.type = type;
+Shader::Shader(
+    const std::vector<std::pair<std::string, std::vector<uint32_t>>>& spirv) {
+  this->data = std::make_shared<Shader::ShaderData>();
+  this->data->stages.resize(spirv.size());
 
-    this->data->reflect(stage);
-    this->data->stages.push_back(stage);
+  for (auto index = size_t(0); index < spirv.size(); index++) {
+    auto& file = spirv[index];
+    this->data->stages[index] = this->data->build(file.first, file.second);
   }
 }
 
 Shader::~Shader() {}
 
+auto Shader::setEmitAssembly(bool enable) -> void { emit_assembly = enable; }
+
 auto Shader::operator=(Shader&& mv) -> Shader& {
   this->data = std::move(mv.data);
   return *this;
@@ -364,47 +576,24 @@ auto Shader::stages() const -> const std::vector<Stage>& {
 }
 
 auto Shader::save(std::string_view path) -> bool {
-  auto sanitized_path = sanitize(path);
-  auto stream = std::ofstream(sanitized_path, std::ios::binary | std::ios::out);
-  OhmAssert(stream, "Could not load file!");
-  auto& stages = this->stages();
-  stream << osh_magic_number;
-  stream << stages.size();
-
-  for (auto& stage : stages) {
-    stream << static_cast<int>(stage.type);
-    stream << stage.name;
-    stream.write(reinterpret_cast<const char*>(stage.spirv.data()),
-                 stage.spirv.size());
-  }
-
-  stream.close();
-  return true;
+  return Osh::write(sanitize(path), this->stages());
 }
 
 auto Shader::load(std::string_view path) -> bool {
-  auto stream = std::ifstream(path.begin(), std::ios::binary | std::ios::in);
-  OhmAssert(stream, "Could not load file!");
-  auto num_stages = 0;
-  auto magic = 0;
+  return this->load(Osh(sanitize(path)));
+}
 
-  this->data = std::make_shared<Shader::ShaderData>();
-  stream >> magic;
-  OhmAssert(magic != osh_magic_number, "Shader magic number not valid.");
-  stream >> num_stages;
-  this->data->stages.resize(num_stages);
-
-  for (auto& stage : this->data->stages) {
-    auto type = 0;
-    stream >> type;
-    stream >> stage.name;
-    stage.type = static_cast<Type>(type);
-    stream.read(reinterpret_cast<char*>(stage.spirv.data()),
-                stage.spirv.size());
-    this->data->reflect(stage);
+auto Shader::load(const Osh& file) -> bool {
+  auto stages = std::vector<Shader::Stage>(file.count());
+  if (!file.valid()) return false;
+
+  // The file carries its reflection, so nothing is reflected again here.
+  for (auto index = size_t(0); index < stages.size(); index++) {
+    if (!file.stage(index, stages[index])) return false;
   }
 
-  stream.close();
+  this->data = std::make_shared<Shader::ShaderData>();
+  this->data->stages = std::move(stages);
   return true;
 }
 }  // namespace v1
@@ -1,4 +1,6 @@
 #pragma once
+#include <array>
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <string>
@@ -9,6 +11,8 @@
 namespace ohm {
 namespace io {
 inline namespace v1 {
+class Osh;
+
 /** Class to handle combining multiple glsl/hlsl shaders into a reflected binary
  * compacted with SPIR-V. This object handles configuring and saving as a binary
  * (denoted by an .osh file), or loading that configuration and reading it.
@@ -69,12 +73,41 @@ class Shader {
       Type type;
     };
 
+    struct PushConstant {
+      std::string name;
+      size_t offset;
+      size_t size;
+    };
+
+    struct SpecConstant {
+      enum class Type : int {
+        Bool,
+        Int,
+        UInt,
+        Float,
+      };
+
+      std::string name;
+      uint32_t id;
+      size_t size;
+      Type type;
+      uint64_t value;  // Default value's bits. Bools are 4 byte, like VkBool32.
+    };
+
     Type type;
     std::string name;
     std::map<std::string, Variable> variables;
     std::vector<uint32_t> spirv;
     std::vector<Attribute> in_attributes;
     std::vector<Attribute> out_attributes;
+    std::vector<PushConstant> push_constants;
+    std::vector<SpecConstant> spec_constants;
+
+    // Local size of compute stages, zero for every other stage.
+    std::array<uint32_t, 3> workgroup = {0, 0, 0};
+
+    // SPIR-V text, only filled in while setEmitAssembly(true) is on.
+    std::string assembly;
   };
 
   explicit Shader();
@@ -82,13 +115,38 @@ class Shader {
   explicit Shader(const std::vector<std::string>& glsl_to_load);
   explicit Shader(
       const std::vector<std::pair<std::string, std::string>>& inline_files);
+
+  /** Constructor to take already compiled stages, named like files so their
+   * types are known. Only reflects, skipping compilation.
+   */
+  explicit Shader(
+      const std::vector<std::pair<std::string, std::vector<uint32_t>>>& spirv);
   explicit Shader(Shader&& mv);
   ~Shader();
   auto operator=(Shader&& mv) -> Shader&;
   auto stages() const -> const std::vector<Stage>&;
+
+  /** Method to write every stage, with its reflection, to an .osh file.
+   * @return Whether the file was written.
+   */
   auto save(std::string_view path) -> bool;
+
+  /** Method to replace this object's stages with an .osh file's.
+   * @return Whether the file was a valid .osh. Nothing changes otherwise.
+   */
   auto load(std::string_view path) -> bool;
 
+  /** Method to replace this object's stages with those of an already opened
+   * .osh, like one found in a shader archive.
+   * @return Whether the container was valid. Nothing changes otherwise.
+   */
+  auto load(const Osh& file) -> bool;
+
+  /** Method to also produce each stage's SPIR-V text when compiling, for
+   * debugging. Costs a second compilation per stage and bypasses the cache.
+   */
+  static auto setEmitAssembly(bool enable) -> void;
+
  private:
   struct ShaderData;
   std::shared_ptr<ShaderData> data;
@@ -98,6 +156,8 @@ using ShaderType = Shader::Type;
 using ShaderVariable = Shader::Stage::Variable;
 using VariableType = Shader::Stage::Variable::Type;
 using AttributeType = Shader::Stage::Attribute::Type;
+using ShaderPushConstant = Shader::Stage::PushConstant;
+using ShaderSpecConstant = Shader::Stage::SpecConstant;
 }  // namespace v1
 }  // namespace io
 
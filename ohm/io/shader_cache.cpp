@@ -0,0 +1,177 @@
+#include "shader_cache.h"
+#include "serialize.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <utility>
+
+namespace ohm {
+namespace io {
+inline namespace v1 {
+constexpr uint32_t cache_magic_number = 0x4853484f;  // "OHSH"
+constexpr uint32_t cache_version = 3;
+
+static auto serialize(uint64_t key, const Shader::Stage& stage)
+    -> std::vector<char> {
+  auto out = Writer();
+  out.value(cache_magic_number);
+  out.value(cache_version);
+  out.value(key);
+
+  out.value<int32_t>(static_cast<int32_t>(stage.type));
+  out.value<uint32_t>(stage.spirv.size());
+  out.raw(stage.spirv.data(), stage.spirv.size() * sizeof(uint32_t));
+  write_reflection(out, stage);
+  return std::move(out.bytes);
+}
+
+static auto deserialize(uint64_t key, const std::vector<char>& bytes,
+                        Shader::Stage& stage) -> bool {
+  auto in = Reader{bytes.data(), bytes.data() + bytes.size()};
+  auto tmp = Shader::Stage();
+
+  // A different format or a colliding file name is just a miss.
+  if (in.value<uint32_t>() != cache_magic_number) return false;
+  if (in.value<uint32_t>() != cache_version) return false;
+  if (in.value<uint64_t>() != key) return false;
+
+  tmp.type = static_cast<Shader::Type>(in.value<int32_t>());
+  auto words = in.value<uint32_t>();
+  if (!in.valid || static_cast<size_t>(in.end - in.ptr) <
+                       static_cast<size_t>(words) * sizeof(uint32_t))
+    return false;
+  tmp.spirv.resize(words);
+  std::memcpy(tmp.spirv.data(), in.ptr, words * sizeof(uint32_t));
+  in.ptr += words * sizeof(uint32_t);
+
+  if (!read_reflection(in, tmp)) return false;
+  stage = std::move(tmp);
+  return true;
+}
+
+ShaderCache::ShaderCache() {
+  this->m_hits = 0;
+  this->m_misses = 0;
+  this->m_enabled = true;
+}
+
+auto ShaderCache::hash(const void* data, size_t size, uint64_t seed)
+    -> uint64_t {
+  // FNV-1a.
+  constexpr auto prime = 0x100000001b3ull;
+  auto* bytes = static_cast<const unsigned char*>(data);
+  for (auto index = size_t(0); index < size; index++) {
+    seed = (seed ^ bytes[index]) * prime;
+  }
+  return seed;
+}
+
+auto ShaderCache::setDirectory(std::string_view directory) -> void {
+  auto lock = std::unique_lock<std::mutex>(this->m_lock);
+  this->m_directory = std::string(directory);
+}
+
+auto ShaderCache::setEnabled(bool enabled) -> void {
+  auto lock = std::unique_lock<std::mutex>(this->m_lock);
+  this->m_enabled = enabled;
+}
+
+/** The lock only guards the table and counters. Files are read with it
+ * released, so threads compiling different stages don't queue on disk I/O.
+ */
+auto ShaderCache::find(uint64_t key, Shader::Stage& stage) -> bool {
+  auto directory = std::string();
+  {
+    auto lock = std::unique_lock<std::mutex>(this->m_lock);
+    if (!this->m_enabled) return false;
+
+    auto iter = this->m_stages.find(key);
+    if (iter != this->m_stages.end()) {
+      auto name = std::move(stage.name);
+      stage = iter->second;
+      stage.name = std::move(name);
+      this->m_hits++;
+      return true;
+    }
+    directory = this->m_directory;
+  }
+
+  if (!directory.empty()) {
+    auto stream = std::ifstream(ShaderCache::path(directory, key),
+                                std::ios::binary);
+    auto bytes = std::vector<char>();
+    auto found = Shader::Stage();
+    if (stream) {
+      bytes.assign(std::istreambuf_iterator<char>(stream),
+                   std::istreambuf_iterator<char>());
+    }
+    if (stream && deserialize(key, bytes, found)) {
+      found.name = std::move(stage.name);
+      {
+        auto lock = std::unique_lock<std::mutex>(this->m_lock);
+        this->m_stages[key] = found;
+        this->m_hits++;
+      }
+      stage = std::move(found);
+      return true;
+    }
+  }
+
+  auto lock = std::unique_lock<std::mutex>(this->m_lock);
+  this->m_misses++;
+  return false;
+}
+
+auto ShaderCache::insert(uint64_t key, const Shader::Stage& stage) -> void {
+  auto directory = std::string();
+  {
+    auto lock = std::unique_lock<std::mutex>(this->m_lock);
+    if (!this->m_enabled) return;
+
+    this->m_stages[key] = stage;
+    directory = this->m_directory;
+  }
+  if (directory.empty()) return;
+
+  write_file(ShaderCache::path(directory, key), serialize(key, stage));
+}
+
+auto ShaderCache::clear() -> void {
+  auto lock = std::unique_lock<std::mutex>(this->m_lock);
+  this->m_stages.clear();
+}
+
+auto ShaderCache::enabled() const -> bool {
+  auto lock = std::unique_lock<std::mutex>(this->m_lock);
+  return this->m_enabled;
+}
+
+auto ShaderCache::hits() const -> size_t {
+  auto lock = std::unique_lock<std::mutex>(this->m_lock);
+  return this->m_hits;
+}
+
+auto ShaderCache::misses() const -> size_t {
+  auto lock = std::unique_lock<std::mutex>(this->m_lock);
+  return this->m_misses;
+}
+
+auto ShaderCache::path(const std::string& directory, uint64_t key)
+    -> std::string {
+  char name[32];
+  std::snprintf(name, sizeof(name), "%016llx.spvc",
+                static_cast<unsigned long long>(key));
+
+  auto file = directory;
+  if (file.back() != '/') file += '/';
+  return file + name;
+}
+
+auto shaderCache() -> ShaderCache& {
+  static ShaderCache cache;
+  return cache;
+}
+}  // namespace v1
+}  // namespace io
+}  // namespace ohm
@@ -0,0 +1,72 @@
+#pragma once
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "shader.h"
+
+namespace ohm {
+namespace io {
+inline namespace v1 {
+/** Object to remember compiled shader stages by the hash of everything that
+ * went into compiling them. Entries are kept in memory and, if a directory is
+ * set, written there as one file per key so later runs skip compilation too.
+ * Safe to use from multiple threads.
+ */
+class ShaderCache {
+ public:
+  ShaderCache();
+  ShaderCache(const ShaderCache& cpy) = delete;
+  ~ShaderCache() = default;
+  auto operator=(const ShaderCache& cpy) -> ShaderCache& = delete;
+
+  /** Method to hash a block of bytes, chaining from a previous hash.
+   */
+  static auto hash(const void* data, size_t size,
+                   uint64_t seed = 0xcbf29ce484222325ull) -> uint64_t;
+
+  /** Method to set the directory entries are read from and written to. An
+   * empty path keeps the cache in memory only.
+   */
+  auto setDirectory(std::string_view directory) -> void;
+
+  /** Method to turn the cache on or off. Disabled caches never hit or store.
+   */
+  auto setEnabled(bool enabled) -> void;
+
+  /** Method to look up a stage, falling back to the directory on a miss in
+   * memory.
+   * @return Whether the stage was found. The stage is untouched otherwise.
+   */
+  auto find(uint64_t key, Shader::Stage& stage) -> bool;
+
+  auto insert(uint64_t key, const Shader::Stage& stage) -> void;
+
+  /** Method to forget every in-memory entry. Files are left alone.
+   */
+  auto clear() -> void;
+
+  auto enabled() const -> bool;
+  auto hits() const -> size_t;
+  auto misses() const -> size_t;
+
+ private:
+  static auto path(const std::string& directory, uint64_t key)
+      -> std::string;
+
+  std::unordered_map<uint64_t, Shader::Stage> m_stages;
+  std::string m_directory;
+  mutable std::mutex m_lock;
+  size_t m_hits;
+  size_t m_misses;
+  bool m_enabled;
+};
+
+/** Method to retrieve the cache used by every io::Shader compilation.
+ */
+auto shaderCache() -> ShaderCache&;
+}  // namespace v1
+}  // namespace io
+}  // namespace ohm
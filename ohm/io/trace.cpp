@@ -0,0 +1,135 @@
+#include "trace.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ohm {
+namespace io {
+inline namespace v1 {
+#ifdef Ohm_Trace
+/** One slot of a ring. Every field is atomic, and the sequence works as a
+ * seqlock: it is odd while the slot is being written, and 2 * (n + 1) once it
+ * holds the thread's nth event. A dump running while the owner wraps around
+ * can then tell an event it read whole from one that was overwritten under it.
+ */
+struct TraceEvent {
+  std::atomic<uint64_t> sequence = {0};
+  std::atomic<const char*> name = {nullptr};
+  std::atomic<uint64_t> begin = {0};
+  std::atomic<uint64_t> end = {0};
+};
+
+/** One thread's ring of events. Only the owning thread writes to it, and it
+ * publishes each event by bumping the head after the event is written.
+ */
+struct TraceRing {
+  std::array<TraceEvent, TRACE_RING_SIZE> events;
+  std::atomic<uint64_t> head = {0};
+  unsigned thread;
+};
+
+/** Rings are registered once per thread and kept alive by the registry, so
+ * they can still be dumped after their thread has exited.
+ */
+struct TraceRegistry {
+  std::mutex lock;
+  std::vector<std::shared_ptr<TraceRing>> rings;
+};
+
+static auto registry() -> TraceRegistry& {
+  static TraceRegistry registry;
+  return registry;
+}
+
+static auto ring() -> TraceRing& {
+  thread_local auto local = [] {
+    auto& reg = registry();
+    auto tmp = std::make_shared<TraceRing>();
+    auto lock = std::unique_lock<std::mutex>(reg.lock);
+    tmp->thread = static_cast<unsigned>(reg.rings.size());
+    reg.rings.push_back(tmp);
+    return tmp;
+  }();
+
+  return *local;
+}
+
+static auto now() -> uint64_t {
+  using Clock = std::chrono::steady_clock;
+  auto time = Clock::now().time_since_epoch();
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(time).count();
+}
+
+TraceZone::TraceZone(const char* name) {
+  this->m_name = name;
+  this->m_begin = now();
+}
+
+TraceZone::~TraceZone() {
+  auto& local = ring();
+  auto head = local.head.load(std::memory_order_relaxed);
+  auto& event = local.events[head % TRACE_RING_SIZE];
+  auto end = now();
+
+  // Releasing each field keeps the odd sequence ahead of it, so a reader
+  // that sees the new value also sees the slot marked as being written.
+  event.sequence.store(head * 2 + 1, std::memory_order_relaxed);
+  event.name.store(this->m_name, std::memory_order_release);
+  event.begin.store(this->m_begin, std::memory_order_release);
+  event.end.store(end, std::memory_order_release);
+  event.sequence.store(head * 2 + 2, std::memory_order_release);
+  local.head.store(head + 1, std::memory_order_release);
+}
+
+auto dumpTrace(std::string_view path) -> bool {
+  auto& reg = registry();
+  auto stream = std::ofstream(std::string(path));
+  auto first = true;
+
+  if (!stream) return false;
+
+  auto lock = std::unique_lock<std::mutex>(reg.lock);
+  stream << std::fixed << std::setprecision(3) << "{\"traceEvents\":[";
+  for (auto& local : reg.rings) {
+    auto head = local->head.load(std::memory_order_acquire);
+    auto begin = head > TRACE_RING_SIZE ? head - TRACE_RING_SIZE : 0;
+    for (auto index = begin; index < head; index++) {
+      auto& event = local->events[index % TRACE_RING_SIZE];
+
+      // Events overwritten while being read are skipped.
+      auto sequence = event.sequence.load(std::memory_order_acquire);
+      if (sequence != index * 2 + 2) continue;
+      auto* name = event.name.load(std::memory_order_acquire);
+      auto start = event.begin.load(std::memory_order_acquire);
+      auto end = event.end.load(std::memory_order_acquire);
+      if (event.sequence.load(std::memory_order_relaxed) != sequence) continue;
+
+      stream << (first ? "" : ",") << "\n{\"name\":\"" << name
+             << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << local->thread
+             << ",\"ts\":" << start / 1000.0
+             << ",\"dur\":" << (end - start) / 1000.0 << "}";
+      first = false;
+    }
+  }
+  stream << "\n]}\n";
+  return true;
+}
+#else
+TraceZone::TraceZone(const char* name) {
+  this->m_name = name;
+  this->m_begin = 0;
+}
+
+TraceZone::~TraceZone() {}
+
+auto dumpTrace(std::string_view) -> bool { return false; }
+#endif
+}  // namespace v1
+}  // namespace io
+}  // namespace ohm
@@ -0,0 +1,49 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+
+/** CPU-side tracing of hot paths. Zones are timed with a steady clock and
+ * pushed into a ring buffer owned by the calling thread, so recording never
+ * takes a lock. Tracing only exists when built with Ohm_Trace; otherwise
+ * OhmTraceZone expands to nothing.
+ */
+#ifdef Ohm_Trace
+#define OhmTraceConcat2(a, b) a##b
+#define OhmTraceConcat(a, b) OhmTraceConcat2(a, b)
+#define OhmTraceZone(name) \
+  ::ohm::io::TraceZone OhmTraceConcat(ohm_trace_zone_, __LINE__)(name)
+#else
+#define OhmTraceZone(name)
+#endif
+
+namespace ohm {
+namespace io {
+inline namespace v1 {
+constexpr auto TRACE_RING_SIZE = 16384u;
+
+/** Object to record a zone from its construction to its destruction.
+ * @note The name must outlive the trace, so string literals are expected.
+ */
+class TraceZone {
+ public:
+  explicit TraceZone(const char* name);
+  TraceZone(const TraceZone& cpy) = delete;
+  ~TraceZone();
+  auto operator=(const TraceZone& cpy) -> TraceZone& = delete;
+
+ private:
+  const char* m_name;
+  uint64_t m_begin;
+};
+
+/** Method to write every thread's recorded zones as Chrome/Perfetto trace
+ * JSON. Only the most recent TRACE_RING_SIZE zones of each thread are kept.
+ * Other threads may keep tracing meanwhile; zones they overwrite while being
+ * dumped are left out.
+ * @param path The file to write to.
+ * @return Whether the file was written. Always false without Ohm_Trace.
+ */
+auto dumpTrace(std::string_view path) -> bool;
+}  // namespace v1
+}  // namespace io
+}  // namespace ohm
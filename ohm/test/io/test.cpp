@@ -1,10 +1,22 @@
 #include <gtest/gtest.h>
 #include <array>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
 #include <iostream>
+#include <iterator>
 #include <memory>
 #include <string>
+#include <thread>
+#include <vector>
+#include "ohm/io/archive.h"
 #include "ohm/io/dlloader.h"
+#include "ohm/io/jobs.h"
+#include "ohm/io/osh.h"
 #include "ohm/io/shader.h"
+#include "ohm/io/shader_cache.h"
+#include "ohm/io/trace.h"
 
 const char* test_compute_shader = {
     "#version 450 core\n"
@@ -38,9 +50,72 @@ const char* test_compute_shader = {
     "  imageStore( output_tex, tex_coords, out_vec ) ;\n"
     "}\n"};
 
+const char* test_push_constant_shader = {
+    "#version 450 core\n"
+    "layout( local_size_x = 32, local_size_y = 1, local_size_z = 1 ) in ; \n"
+    "layout( binding = 0 ) buffer Values\n"
+    "{\n"
+    "  float values[];\n"
+    "} data;\n"
+    "layout( push_constant ) uniform Constants\n"
+    "{\n"
+    "  float scale ;\n"
+    "  uint  count ;\n"
+    "} constants;\n"
+    "void main()\n"
+    "{\n"
+    "  const uint index = gl_GlobalInvocationID.x ;\n"
+    "  if( index < constants.count ) data.values[ index ] *= constants.scale ;\n"
+    "}\n"};
+
+const char* test_spec_constant_shader = {
+    "#version 450 core\n"
+    "layout( constant_id = 0 ) const uint  TILE  = 16    ;\n"
+    "layout( constant_id = 1 ) const bool  FAST  = false ;\n"
+    "layout( constant_id = 4 ) const float SCALE = 1.5   ;\n"
+    "layout( local_size_x = 32, local_size_y = 1, local_size_z = 1 ) in ; \n"
+    "layout( binding = 0 ) buffer Values\n"
+    "{\n"
+    "  float values[];\n"
+    "} data;\n"
+    "void main()\n"
+    "{\n"
+    "  const uint index = gl_GlobalInvocationID.x * TILE ;\n"
+    "  if( FAST ) data.values[ index ] *= SCALE ;\n"
+    "}\n"};
+
+const char* test_vertex_shader = {
+    "#version 450 core\n"
+    "layout( location = 0 ) in  vec4 position ;\n"
+    "layout( location = 0 ) out vec2 coords   ;\n"
+    "void main()\n"
+    "{\n"
+    "  coords      = position.zw ;\n"
+    "  gl_Position = vec4( position.xy, 0.0, 1.0 ) ;\n"
+    "}\n"};
+
+const char* test_fragment_shader = {
+    "#version 450 core\n"
+    "layout( location = 0 ) in  vec2 coords    ;\n"
+    "layout( location = 0 ) out vec4 out_color ;\n"
+    "void main()\n"
+    "{\n"
+    "  out_color = vec4( coords, 0.0, 1.0 ) ;\n"
+    "}\n"};
+
 std::vector<std::pair<std::string, std::string>> shaders = {
     {std::string("test.comp"), std::string(test_compute_shader)}};
 
+std::vector<std::pair<std::string, std::string>> push_constant_shaders = {
+    {std::string("push.comp"), std::string(test_push_constant_shader)}};
+
+std::vector<std::pair<std::string, std::string>> spec_constant_shaders = {
+    {std::string("spec.comp"), std::string(test_spec_constant_shader)}};
+
+std::vector<std::pair<std::string, std::string>> graphics_shaders = {
+    {std::string("test.vert"), std::string(test_vertex_shader)},
+    {std::string("test.frag"), std::string(test_fragment_shader)}};
+
 namespace ohm {
 namespace io {
 auto test_initialization() -> bool {
@@ -88,6 +163,203 @@ auto test_variable_validation() -> bool {
 
   return true;
 }
+
+auto test_push_constant_reflection() -> bool {
+  auto shader = io::Shader(push_constant_shaders);
+  auto& stage = shader.stages()[0];
+
+  if (stage.push_constants.size() != 1) return false;
+
+  auto& block = stage.push_constants[0];
+  return block.offset == 0 && block.size == sizeof(float) + sizeof(uint32_t);
+}
+
+auto test_no_push_constants() -> bool {
+  auto shader = io::Shader(shaders);
+  return shader.stages()[0].push_constants.empty();
+}
+
+auto test_spec_constant_reflection() -> bool {
+  using Type = io::ShaderSpecConstant::Type;
+  auto shader = io::Shader(spec_constant_shaders);
+  auto& constants = shader.stages()[0].spec_constants;
+  if (constants.size() != 3) return false;
+
+  auto scale = 0.f;
+  std::memcpy(&scale, &constants[2].value, sizeof(float));
+  return constants[0].name == "TILE" && constants[0].id == 0 &&
+         constants[0].type == Type::UInt && constants[0].value == 16 &&
+         constants[1].name == "FAST" && constants[1].type == Type::Bool &&
+         constants[1].value == 0 && constants[2].id == 4 &&
+         constants[2].type == Type::Float && constants[2].size == 4 &&
+         scale == 1.5f;
+}
+
+auto test_multi_stage_order() -> bool {
+  auto shader = io::Shader(graphics_shaders);
+  auto& stages = shader.stages();
+
+  if (stages.size() != 2) return false;
+  return stages[0].name == "test.vert" &&
+         stages[0].type == io::Shader::Type::Vertex &&
+         stages[1].name == "test.frag" &&
+         stages[1].type == io::Shader::Type::Fragment &&
+         !stages[0].spirv.empty() && !stages[1].spirv.empty();
+}
+
+auto test_precompiled_reflection() -> bool {
+  auto compiled = io::Shader(shaders);
+  auto& source = compiled.stages()[0];
+  auto spirv = std::vector<std::pair<std::string, std::vector<uint32_t>>>();
+  spirv.push_back({source.name, source.spirv});
+  auto shader = io::Shader(spirv);
+
+  if (shader.stages().size() != 1) return false;
+  auto& stage = shader.stages()[0];
+  return stage.type == io::Shader::Type::Compute &&
+         stage.spirv == source.spirv &&
+         stage.variables.size() == source.variables.size() &&
+         stage.workgroup == source.workgroup;
+}
+
+auto test_shader_cache() -> bool {
+  auto& cache = io::shaderCache();
+  cache.clear();
+
+  auto hits = cache.hits();
+  auto first = io::Shader(shaders);
+  auto second = io::Shader(shaders);
+
+  if (cache.hits() != hits + 1) return false;
+  return first.stages()[0].spirv == second.stages()[0].spirv &&
+         first.stages()[0].variables.size() ==
+             second.stages()[0].variables.size();
+}
+
+auto test_emit_assembly() -> bool {
+  io::Shader::setEmitAssembly(true);
+  auto debug = io::Shader(shaders);
+  io::Shader::setEmitAssembly(false);
+  auto plain = io::Shader(shaders);
+
+  auto& text = debug.stages()[0].assembly;
+  return text.find("OpEntryPoint") != std::string::npos &&
+         plain.stages()[0].assembly.empty() &&
+         debug.stages()[0].spirv == plain.stages()[0].spirv;
+}
+
+auto test_osh_round_trip() -> bool {
+  auto path = std::string("ohm_test_round_trip.osh");
+  auto compute = io::Shader(shaders);
+  auto graphics = io::Shader(graphics_shaders);
+  if (!compute.save(path)) return false;
+
+  // Loading replaces the stages outright.
+  auto loaded_ok = graphics.load(path);
+  auto file = io::Osh(path);
+  std::remove(path.c_str());
+  if (!loaded_ok || graphics.stages().size() != 1 || file.count() != 1)
+    return false;
+
+  auto& loaded = graphics.stages()[0];
+  auto& saved = compute.stages()[0];
+  if (loaded.workgroup != std::array<uint32_t, 3>{32, 32, 1}) return false;
+  if (file.words(0) != saved.spirv.size() || file.name(0) != saved.name)
+    return false;
+
+  return loaded.name == saved.name && loaded.type == saved.type &&
+         loaded.spirv == saved.spirv &&
+         loaded.variables.size() == saved.variables.size() &&
+         loaded.in_attributes.size() == saved.in_attributes.size() &&
+         loaded.push_constants.size() == saved.push_constants.size() &&
+         !io::Shader().load("ohm_test_missing.osh");
+}
+
+auto test_shader_archive() -> bool {
+  auto path = std::string("ohm_test_archive.oar");
+  auto compute = io::Shader(shaders);
+  auto graphics = io::Shader(graphics_shaders);
+  if (!io::ShaderArchive::write(path, {{"compute", compute.stages()},
+                                       {"graphics", graphics.stages()}}))
+    return false;
+
+  auto archive = io::ShaderArchive(path);
+  auto found = archive.find("graphics");
+  auto loaded = io::Shader();
+  auto ok = archive.count() == 2 && found.count() == 2 && loaded.load(found) &&
+            !archive.find("missing").valid();
+  std::remove(path.c_str());
+
+  return ok && loaded.stages().size() == 2 &&
+         loaded.stages()[1].name == graphics.stages()[1].name &&
+         loaded.stages()[1].spirv == graphics.stages()[1].spirv;
+}
+
+auto test_prebuilt_osh() -> bool {
+  // Compiled by oshc while building, see ohm_add_shaders in CMakeLists.txt.
+  auto shader = io::Shader();
+  if (!shader.load("test_prebuilt.osh")) return false;
+
+  auto& stages = shader.stages();
+  return stages.size() == 1 && stages[0].name == "test.comp" &&
+         stages[0].type == io::Shader::Type::Compute &&
+         stages[0].variables.size() == 3 &&
+         stages[0].workgroup == std::array<uint32_t, 3>{32, 32, 1};
+}
+
+auto test_parallel_for() -> bool {
+  constexpr auto count = 4096u;
+  auto hits = std::vector<std::atomic<unsigned>>(count);
+
+  // Nested batches must not deadlock, since waiting threads run jobs too.
+  io::jobs().parallelFor(count, [&hits](size_t index) {
+    hits[index]++;
+    if (index % 512 == 0) io::jobs().parallelFor(4, [](size_t) {});
+  });
+
+  for (auto& hit : hits) {
+    if (hit != 1) return false;
+  }
+  return true;
+}
+
+auto test_async() -> bool {
+  auto future = io::jobs().async([]() { return 1337; });
+  return future.get() == 1337;
+}
+
+auto test_trace_dump() -> bool {
+  const auto path = std::string("ohm_test_trace.json");
+  auto done = std::atomic<bool>(false);
+
+  // Wraps its ring over and over while the dumps below read it.
+  auto writer = std::thread([&done]() {
+    while (!done) {
+      OhmTraceZone("test_trace_writer");
+    }
+  });
+
+  {
+    OhmTraceZone("test_trace_zone");
+  }
+
+  auto dumped = true;
+  for (auto index = 0; index < 8; index++) dumped &= io::dumpTrace(path);
+  done = true;
+  writer.join();
+
+#ifdef Ohm_Trace
+  auto stream = std::ifstream(path);
+  auto json = std::string(std::istreambuf_iterator<char>(stream),
+                          std::istreambuf_iterator<char>());
+  stream.close();
+  std::remove(path.c_str());
+  return dumped &&
+         json.find("\"name\":\"test_trace_zone\"") != std::string::npos;
+#else
+  return !dumped;
+#endif
+}
 }  // namespace io
 }  // namespace ohm
 
@@ -96,6 +368,25 @@ TEST(IO, Shader) {
   EXPECT_TRUE(ohm::io::test_compilation_from_src());
   EXPECT_TRUE(ohm::io::test_variable_recognition());
   EXPECT_TRUE(ohm::io::test_variable_validation());
+  EXPECT_TRUE(ohm::io::test_push_constant_reflection());
+  EXPECT_TRUE(ohm::io::test_no_push_constants());
+  EXPECT_TRUE(ohm::io::test_spec_constant_reflection());
+  EXPECT_TRUE(ohm::io::test_multi_stage_order());
+  EXPECT_TRUE(ohm::io::test_precompiled_reflection());
+  EXPECT_TRUE(ohm::io::test_shader_cache());
+  EXPECT_TRUE(ohm::io::test_emit_assembly());
+  EXPECT_TRUE(ohm::io::test_osh_round_trip());
+  EXPECT_TRUE(ohm::io::test_shader_archive());
+  EXPECT_TRUE(ohm::io::test_prebuilt_osh());
+}
+
+TEST(IO, Jobs) {
+  EXPECT_TRUE(ohm::io::test_parallel_for());
+  EXPECT_TRUE(ohm::io::test_async());
+}
+
+TEST(IO, Trace) {
+  EXPECT_TRUE(ohm::io::test_trace_dump());
 }
 
 auto main(int argc, char* argv[]) -> int {
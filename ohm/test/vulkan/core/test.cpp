@@ -1,11 +1,13 @@
 #include <gtest/gtest.h>
 #include <array>
+#include <filesystem>
 #include <iostream>
 #include <memory>
 #include "ohm/api/ohm.h"
 #include "ohm/vulkan/vulkan_impl.h"
 #include <iostream>
 #include <map>
+#include <vector>
 
 namespace ohm {
 using API = ohm::Vulkan;
@@ -41,6 +43,41 @@ const char* test_compute_shader = {
     "  imageStore( output_tex, tex_coords, out_vec ) ;\n"
     "}\n"};
 
+const char* test_index_shader = {
+    "#version 450 core\n"
+    "layout( local_size_x = 32 ) in ;\n"
+    "layout( binding = 0 ) buffer Values\n"
+    "{\n"
+    "  uint values[];\n"
+    "} output_values;\n"
+    "void main()\n"
+    "{\n"
+    "  const uint index = gl_GlobalInvocationID.x;\n"
+    "  output_values.values[index] = index;\n"
+    "}\n"};
+
+const char* test_bindless_shader = {
+    "#version 450 core\n"
+    "#extension GL_EXT_nonuniform_qualifier : enable\n"
+    "layout( local_size_x = 32 ) in ;\n"
+    "layout( push_constant ) uniform Heap\n"
+    "{\n"
+    "  uint index;\n"
+    "} heap;\n"
+    "layout( binding = 0 ) buffer Values\n"
+    "{\n"
+    "  float values[];\n"
+    "} output_values;\n"
+    "layout( set = 1, binding = 2 ) buffer Arrays\n"
+    "{\n"
+    "  float data[];\n"
+    "} arrays[];\n"
+    "void main()\n"
+    "{\n"
+    "  const uint index = gl_GlobalInvocationID.x;\n"
+    "  output_values.values[index] = 2.0f * arrays[heap.index].data[index];\n"
+    "}\n"};
+
 const char* test_vert_shader = 
 "#version 440 core\n"
 "layout(location = 0) in vec2 pos;\n"
@@ -90,6 +127,29 @@ auto test_set_param() -> bool {
   System<API>::setParameter("lmao");
   return true;
 }
+
+auto test_pipeline_cache() -> bool {
+  namespace fs = std::filesystem;
+  auto directory = fs::temp_directory_path() / "ohm_pipeline_cache_test";
+  auto found = false;
+
+  fs::create_directories(directory);
+  System<API>::setPipelineCache(directory.string());
+  {
+    auto pipeline =
+        Pipeline<API>(0, {{{"test_shader.comp.glsl", test_compute_shader}}});
+    System<API>::savePipelineCache();
+  }
+  System<API>::setPipelineCache("");
+
+  for (auto& entry : fs::directory_iterator(directory)) {
+    auto name = entry.path().filename().string();
+    found |= name.rfind("ohm_pipeline_cache_", 0) == 0 &&
+             entry.path().extension() == ".bin" && fs::file_size(entry) > 0;
+  }
+  fs::remove_all(directory);
+  return found;
+}
 }  // namespace sys
 
 namespace memory {
@@ -183,6 +243,52 @@ auto test_getters() -> bool {
 
   return pass;
 }
+
+auto test_bindless_index() -> bool {
+  auto image = Image<API>(0, {64, 64, ImageFormat::RGBA32F});
+  auto other = Image<API>(0, {64, 64, ImageFormat::RGBA32F});
+  auto array = Array<API, float>(0, 64);
+
+  // Without bindless mode every index is -1, otherwise each is unique.
+  if (image.bindless() < 0)
+    return other.bindless() < 0 && array.bindless() < 0;
+  return image.bindless() != other.bindless() && array.bindless() >= 0;
+}
+
+auto has_heap() -> bool { return Array<API, float>(0, 1).bindless() >= 0; }
+
+auto test_bindless_read() -> bool {
+  constexpr auto count = 64u;
+  auto input = Array<API, float>(0, count, HeapType::HostVisible);
+  auto unbound = Array<API, float>();
+  if (input.bindless() < 0 || unbound.bindless() != -1) return false;
+
+  auto output = Array<API, float>(0, count, HeapType::HostVisible);
+  auto pipeline =
+      Pipeline<API>(0, {{{"test_bindless.comp.glsl", test_bindless_shader}}});
+  auto commands = Commands<API>(0);
+  auto descriptor = pipeline.descriptor();
+  auto index = static_cast<uint32_t>(input.bindless());
+  std::array<float, count> host_input;
+  std::array<float, count> host_output;
+
+  for (auto i = 0u; i < count; i++) host_input[i] = static_cast<float>(i);
+  descriptor.bind("output_values", output);
+
+  commands.begin();
+  commands.copy(host_input.data(), input);
+  commands.bind(descriptor);
+  commands.push(index);
+  commands.dispatch(count / 32, 1, 1);
+  commands.submit();
+  commands.synchronize();
+
+  commands.copy(output, host_output.data());
+  for (auto i = 0u; i < count; i++) {
+    if (host_output[i] != 2.0f * host_input[i]) return false;
+  }
+  return true;
+}
 }  // namespace image
 namespace render_pass {
 auto test_creation() -> bool {
@@ -240,6 +346,121 @@ auto test_correct_gpu() -> bool {
       Pipeline<API>(0, {{{"test_shader.comp.glsl", test_compute_shader}}});
   return pipeline.gpu() == 0;
 }
+
+auto test_create_many() -> bool {
+  constexpr auto count = 8u;
+  auto info = PipelineInfo();
+  info.inline_files = {{"test_shader.comp.glsl", test_compute_shader}};
+  auto infos = std::vector<PipelineInfo>(count, info);
+  auto pipelines = Pipeline<API>::createMany(0, infos);
+
+  if (pipelines.size() != count) return false;
+  for (auto index = 0u; index < count; index++) {
+    if (pipelines[index].handle() < 0) return false;
+    for (auto other = 0u; other < index; other++) {
+      if (pipelines[index].handle() == pipelines[other].handle()) return false;
+    }
+  }
+  return true;
+}
+
+auto test_archive_creation() -> bool {
+  auto path = std::string("ohm_test_pipelines.oar");
+  auto shader = io::Shader(std::vector<std::pair<std::string, std::string>>{
+      {"test_shader.comp.glsl", test_compute_shader}});
+  if (!io::ShaderArchive::write(path, {{"threshold", shader.stages()}}))
+    return false;
+
+  auto archive = io::ShaderArchive(path);
+  auto pipeline = Pipeline<API>(0, PipelineInfo(archive, "threshold"));
+  auto missing = PipelineInfo(archive, "missing");
+  archive.close();
+  std::remove(path.c_str());
+
+  return pipeline.handle() >= 0 && pipeline.descriptor().handle() >= 0 &&
+         !missing.shader;
+}
+
+auto test_precompiled_creation() -> bool {
+  auto shader = std::make_shared<const io::Shader>(
+      std::vector<std::pair<std::string, std::string>>{
+          {"test_shader.comp.glsl", test_compute_shader}});
+  auto& stage = shader->stages()[0];
+
+  auto from_shader = Pipeline<API>(0, PipelineInfo(shader));
+  auto from_spirv = Pipeline<API>(
+      0, PipelineInfo({{std::string("test_shader.comp.glsl"), stage.spirv}}));
+  return from_shader.handle() >= 0 && from_spirv.handle() >= 0 &&
+         from_spirv.descriptor().handle() >= 0;
+}
+
+auto test_specialization() -> bool {
+  const char* shader =
+      "#version 450 core\n"
+      "layout( constant_id = 0 ) const uint  TILE  = 16  ;\n"
+      "layout( constant_id = 1 ) const float SCALE = 1.0 ;\n"
+      "layout( local_size_x = 32 ) in ;\n"
+      "layout( binding = 0 ) buffer Values { float values[]; } data ;\n"
+      "void main()\n"
+      "{\n"
+      "  data.values[ gl_GlobalInvocationID.x ] = float( TILE ) * SCALE ;\n"
+      "}\n";
+
+  constexpr auto count = 32u;
+  auto info = PipelineInfo();
+  info.inline_files = {{"spec.comp", shader}};
+  info.specialize(0, 64u);
+  info.specialize(1, 2.f);
+  auto pipeline = Pipeline<API>(0, info);
+  auto values = Array<API, float>(0, count, HeapType::HostVisible);
+  auto commands = Commands<API>(0);
+  auto descriptor = pipeline.descriptor();
+  std::array<float, count> host_values;
+
+  descriptor.bind("data", values);
+  commands.begin();
+  commands.bind(descriptor);
+  commands.dispatch(1, 1, 1);
+  commands.submit();
+  commands.synchronize();
+
+  // The defaults would give 16; both overrides give 64 * 2.
+  commands.copy(values, host_values.data());
+  for (auto value : host_values) {
+    if (value != 128.f) return false;
+  }
+  return true;
+}
+
+auto test_async_creation() -> bool {
+  auto info = PipelineInfo();
+  info.inline_files = {{"test_shader.comp.glsl", test_compute_shader}};
+  auto pipeline = Pipeline<API>::createAsync(0, info);
+  auto other = Pipeline<API>::createAsync(0, info);
+  if (pipeline.handle() < 0 || pipeline.handle() == other.handle())
+    return false;
+
+  pipeline.wait();
+  return pipeline.ready() && pipeline.descriptor().handle() >= 0;
+}
+
+auto test_shared_creation() -> bool {
+  auto info = PipelineInfo();
+  info.inline_files = {{"test_shader.comp.glsl", test_compute_shader}};
+  auto first = Pipeline<API>::shared(0, info);
+  auto handle = first.handle();
+  {
+    auto second = Pipeline<API>::shared(0, info);
+    if (second.handle() != handle) return false;
+  }
+
+  // Still alive after the second reference is gone, and distinct once the
+  // creation state differs.
+  if (first.descriptor().handle() < 0) return false;
+  info.specialize(0, 1u);
+  auto third = Pipeline<API>::shared(0, info);
+  return third.handle() >= 0 && third.handle() != handle;
+}
 }  // namespace pipeline
 namespace descriptor {
 auto test_creation() -> bool {
@@ -257,6 +478,69 @@ auto test_binding() -> bool {
   descriptor.bind("input_tex", image);
   return descriptor.handle() >= 0;
 }
+
+auto test_binding_ids() -> bool {
+  auto pipeline =
+      Pipeline<API>(0, {{{"test_shader.comp.glsl", test_compute_shader}}});
+  auto image = Image<API>(0, {1024, 1024, ImageFormat::RGBA32F});
+  auto input = pipeline.binding("input_tex");
+  auto output = pipeline.binding("output_tex");
+  if (input < 0 || output < 0 || input == output) return false;
+  if (pipeline.binding("not_a_variable") >= 0) return false;
+
+  static_assert(bindingHash("input_tex") != bindingHash("output_tex"),
+                "Names are hashed at compile time.");
+
+  auto descriptor = pipeline.descriptor();
+  descriptor.bind(input, image);
+  descriptor.bind(output, image);
+  descriptor.commit();
+  return descriptor.handle() >= 0;
+}
+
+auto test_pool_growth() -> bool {
+  constexpr auto count = 100;
+  auto pipeline =
+      Pipeline<API>(0, {{{"test_shader.comp.glsl", test_compute_shader}}});
+  auto image = Image<API>(0, {1024, 1024, ImageFormat::RGBA32F});
+  auto descriptors = std::vector<Descriptor<API>>();
+  descriptors.reserve(count);
+
+  // More than the first pool holds, so the pool has to grow.
+  for (auto index = 0; index < count; index++) {
+    descriptors.push_back(pipeline.descriptor());
+    if (descriptors.back().handle() < 0) return false;
+  }
+
+  descriptors.back().bind("input_tex", image);
+  descriptors.back().commit();
+  return true;
+}
+
+auto test_transient() -> bool {
+  auto pipeline =
+      Pipeline<API>(0, {{{"test_shader.comp.glsl", test_compute_shader}}});
+  auto input = Image<API>(0, {1024, 1024, ImageFormat::RGBA32F});
+  auto output = Image<API>(0, {1024, 1024, ImageFormat::RGBA32F});
+  auto config = Array<API, float>(0, 1, HeapType::HostVisible);
+  auto commands = Commands<API>(0);
+
+  for (auto frame = 0; frame < 4; frame++) {
+    auto descriptor = pipeline.transientDescriptor();
+    if (descriptor.handle() < 0) return false;
+    descriptor.bind("input_tex", input);
+    descriptor.bind("output_tex", output);
+    descriptor.bind("config", config);
+
+    commands.begin();
+    commands.bind(descriptor);
+    commands.dispatch(1024 / 32, 1024 / 32);
+    commands.submit();
+    pipeline.retire(commands);
+  }
+  commands.synchronize();
+  return true;
+}
 }  // namespace descriptor
 namespace window {
 auto test_creation() -> bool {
@@ -396,6 +680,194 @@ auto test_image_copy() -> bool {
   return true;
 }
 
+auto test_region_array_copy() -> bool {
+  constexpr auto cache_size = 1024;
+  auto commands = Commands<API>(0);
+  auto src = Array<API, int>(0, cache_size, HeapType::HostVisible);
+  auto dst = Array<API, int>(0, cache_size, HeapType::HostVisible);
+  std::array<int, cache_size> host_array;
+
+  for (auto index = 0; index < cache_size; index++) host_array[index] = index;
+
+  commands.begin();
+  commands.copy(host_array.data(), src);
+  commands.copy(src, dst, {{0, 512, 256}, {768, 0, 256}});
+  commands.submit();
+  commands.synchronize();
+
+  commands.copy(dst, host_array.data());
+  for (auto index = 0; index < 256; index++) {
+    if (host_array[512 + index] != index) return false;
+    if (host_array[index] != 768 + index) return false;
+  }
+  return true;
+}
+
+auto test_region_image_copy() -> bool {
+  constexpr auto size = 64u;
+  constexpr auto patch_size = 16u;
+  constexpr auto texel = 4u;
+  auto background = Array<API, unsigned char>(0, size * size * texel,
+                                              HeapType::HostVisible);
+  auto patch = Array<API, unsigned char>(
+      0, patch_size * patch_size * texel, HeapType::HostVisible);
+  auto whole = Array<API, unsigned char>(0, size * size * texel,
+                                         HeapType::HostVisible);
+  auto cutout = Array<API, unsigned char>(
+      0, patch_size * patch_size * texel, HeapType::HostVisible);
+  auto image = Image<API>(0, {size, size});
+  auto commands = Commands<API>(0);
+  auto region = ImageRegion();
+  region.x = 8;
+  region.y = 4;
+  region.width = patch_size;
+  region.height = patch_size;
+
+  auto host_background = std::vector<unsigned char>(size * size * texel, 7);
+  auto host_patch = std::vector<unsigned char>(patch_size * patch_size * texel);
+  for (auto i = 0u; i < host_patch.size(); i++) host_patch[i] = i % 251 + 1;
+  auto host_whole = std::vector<unsigned char>(host_background.size());
+  auto host_cutout = std::vector<unsigned char>(host_patch.size());
+
+  // Each step reads what the last wrote, so they're submitted one at a time.
+  auto run = [&commands](auto&& record) {
+    commands.begin();
+    record();
+    commands.submit();
+    commands.synchronize();
+  };
+
+  commands.copy(host_background.data(), background);
+  commands.copy(host_patch.data(), patch);
+  run([&] { commands.copy(background, image); });
+  run([&] { commands.copy(patch, image, {region}); });
+  run([&] {
+    commands.copy(image, whole, {ImageRegion()});
+    commands.copy(image, cutout, {region});
+  });
+  commands.copy(whole, host_whole.data());
+  commands.copy(cutout, host_cutout.data());
+
+  if (host_cutout != host_patch) return false;
+  for (auto y = 0u; y < size; y++) {
+    for (auto x = 0u; x < size; x++) {
+      auto inside = x >= region.x && x < region.x + patch_size &&
+                    y >= region.y && y < region.y + patch_size;
+      for (auto c = 0u; c < texel; c++) {
+        auto got = host_whole[(y * size + x) * texel + c];
+        auto expected =
+            inside ? host_patch[((y - region.y) * patch_size + x - region.x) *
+                                    texel +
+                                c]
+                   : host_background[(y * size + x) * texel + c];
+        if (got != expected) return false;
+      }
+    }
+  }
+  return true;
+}
+
+auto test_fill_and_update() -> bool {
+  constexpr auto cache_size = 1024;
+  auto commands = Commands<API>(0);
+  auto array = Array<API, unsigned>(0, cache_size, HeapType::HostVisible);
+  std::array<unsigned, 4> patch = {1, 2, 3, 4};
+  std::array<unsigned, cache_size> host_array;
+
+  commands.begin();
+  commands.fill(array, 1337);
+
+  // Both are transfer writes to the same range, so the update has to wait.
+  commands.barrier();
+  commands.update(array, patch.data(), patch.size(), 16);
+  commands.submit();
+  commands.synchronize();
+
+  commands.copy(array, host_array.data());
+  for (auto index = 0u; index < cache_size; index++) {
+    auto in_patch = index >= 16 && index < 16 + patch.size();
+    auto expected = in_patch ? patch[index - 16] : 1337u;
+    if (host_array[index] != expected) return false;
+  }
+  return true;
+}
+
+auto test_indirect_dispatch() -> bool {
+  constexpr auto count = 1024u;
+  auto pipeline =
+      Pipeline<API>(0, {{{"test_index.comp.glsl", test_index_shader}}});
+  auto values = Array<API, unsigned>(0, count, HeapType::HostVisible);
+  auto args = Array<API, DispatchCommand>(0, 1, HeapType::HostVisible);
+  auto commands = Commands<API>(0);
+  auto descriptor = pipeline.descriptor();
+  auto host_args = DispatchCommand{count / 32, 1, 1};
+  std::array<unsigned, count> host_values;
+
+  descriptor.bind("output_values", values);
+
+  commands.begin();
+  commands.copy(&host_args, args);
+  commands.bind(descriptor);
+  commands.dispatchIndirect(args);
+  commands.submit();
+  commands.synchronize();
+
+  commands.copy(values, host_values.data());
+  for (auto index = 0u; index < count; index++) {
+    if (host_values[index] != index) return false;
+  }
+  return true;
+}
+
+auto test_redundant_binds() -> bool {
+  auto pipeline =
+      Pipeline<API>(0, {{{"test_shader.comp.glsl", test_compute_shader}}});
+  auto input = Image<API>(0, {1024, 1024, ImageFormat::RGBA32F});
+  auto output = Image<API>(0, {1024, 1024, ImageFormat::RGBA32F});
+  auto config = Array<API, float>(0, 1, HeapType::HostVisible);
+  auto commands = Commands<API>(0);
+  auto descriptor = pipeline.descriptor();
+
+  descriptor.bind("input_tex", input);
+  descriptor.bind("output_tex", output);
+  descriptor.bind("config", config);
+
+  commands.begin();
+  commands.bind(descriptor);
+  commands.dispatch(1024 / 32, 1024 / 32);
+  commands.bind(descriptor);
+  commands.dispatch(1024 / 32, 1024 / 32);
+  auto skipped = commands.skippedBinds();
+  commands.submit();
+  commands.synchronize();
+  return skipped == 2;
+}
+
+auto test_profiling_scopes() -> bool {
+  constexpr auto count = 1024u;
+  auto pipeline =
+      Pipeline<API>(0, {{{"test_index.comp.glsl", test_index_shader}}});
+  auto values = Array<API, unsigned>(0, count);
+  auto commands = Commands<API>(0);
+  auto descriptor = pipeline.descriptor();
+
+  descriptor.bind("output_values", values);
+
+  commands.profile(true, true);
+  commands.begin();
+  commands.beginScope("dispatch");
+  commands.bind(descriptor);
+  commands.dispatch(count / 32, 1, 1);
+  commands.endScope();
+  commands.submit();
+  commands.synchronize();
+
+  auto scopes = commands.scopes();
+  if (scopes.size() != 1) return false;
+  return scopes[0].name == "dispatch" && scopes[0].milliseconds > 0.0 &&
+         scopes[0].compute_invocations > 0;
+}
+
 auto test_render_pass_rendering() -> bool {
   struct vec4{
     float x, y;
@@ -418,12 +890,57 @@ auto test_render_pass_rendering() -> bool {
   return true;
 }
 }  // namespace commands
+namespace graph {
+auto test_culling_and_aliasing() -> bool {
+  constexpr auto count = 1024u;
+  auto graph = Graph<API>(0);
+  auto src = Array<API, unsigned>(0, count, HeapType::HostVisible);
+  auto dst = Array<API, unsigned>(0, count, HeapType::HostVisible);
+  std::array<unsigned, count> host_src;
+  std::array<unsigned, count> host_dst;
+
+  for (auto index = 0u; index < count; index++) host_src[index] = index;
+  graph.commands().begin();
+  graph.commands().copy(host_src.data(), src);
+  graph.commands().submit();
+  graph.commands().synchronize();
+
+  auto in = graph.import(src);
+  auto out = graph.import(dst);
+  auto first = graph.create<unsigned>(count);
+  auto second = graph.create<unsigned>(count);
+  auto third = graph.create<unsigned>(count);
+  auto unused = graph.create<unsigned>(count);
+
+  auto chain = [&graph](GraphResource from, GraphResource to) {
+    return [&graph, from, to](Commands<API>& cmds) {
+      cmds.copy(graph.array<unsigned>(from), graph.array<unsigned>(to));
+    };
+  };
+
+  graph.addPass("first", {in}, {first}, chain(in, first));
+  graph.addPass("unused", {in}, {unused}, chain(in, unused));
+  graph.addPass("second", {first}, {second}, chain(first, second));
+  graph.addPass("third", {second}, {third}, chain(second, third));
+  graph.addPass("resolve", {third}, {out}, chain(third, out));
+  graph.execute();
+  graph.commands().synchronize();
+
+  // The first and third transients never live at the same time.
+  if (graph.culled() != 1 || graph.barriers() != 3) return false;
+  if (graph.aliasedSize() == 0) return false;
+
+  graph.commands().copy(dst, host_dst.data());
+  return host_src == host_dst;
+}
+}  // namespace graph
 }  // namespace ohm
 
 TEST(Vulkan, System) {
   EXPECT_TRUE(ohm::sys::test_name());
   EXPECT_TRUE(ohm::sys::test_devices());
   EXPECT_TRUE(ohm::sys::test_set_param());
+  EXPECT_TRUE(ohm::sys::test_pipeline_cache());
 }
 
 TEST(Vulkan, Memory) {
@@ -445,17 +962,27 @@ TEST(Vulkan, Image) {
   EXPECT_TRUE(ohm::image::test_creation());
   EXPECT_TRUE(ohm::image::test_getters());
   EXPECT_TRUE(ohm::image::test_memory_allocation());
+  EXPECT_TRUE(ohm::image::test_bindless_index());
 }
 
 TEST(Vulkan, Pipeline) {
   EXPECT_TRUE(ohm::pipeline::test_creation());
   EXPECT_TRUE(ohm::pipeline::test_graphics_creation());
   EXPECT_TRUE(ohm::pipeline::test_correct_gpu());
+  EXPECT_TRUE(ohm::pipeline::test_create_many());
+  EXPECT_TRUE(ohm::pipeline::test_precompiled_creation());
+  EXPECT_TRUE(ohm::pipeline::test_archive_creation());
+  EXPECT_TRUE(ohm::pipeline::test_specialization());
+  EXPECT_TRUE(ohm::pipeline::test_async_creation());
+  EXPECT_TRUE(ohm::pipeline::test_shared_creation());
 }
 
 TEST(Vulkan, Descriptor) {
   EXPECT_TRUE(ohm::descriptor::test_creation());
   EXPECT_TRUE(ohm::descriptor::test_binding());
+  EXPECT_TRUE(ohm::descriptor::test_binding_ids());
+  EXPECT_TRUE(ohm::descriptor::test_pool_growth());
+  EXPECT_TRUE(ohm::descriptor::test_transient());
 }
 
 TEST(Vulkan, Window) {
@@ -464,6 +991,11 @@ TEST(Vulkan, Window) {
   EXPECT_TRUE(ohm::window::test_images_params());
 }
 
+TEST(Vulkan, Bindless) {
+  if (!ohm::image::has_heap()) GTEST_SKIP() << "The device has no heap.";
+  EXPECT_TRUE(ohm::image::test_bindless_read());
+}
+
 TEST(Vulkan, RenderPass) {
   EXPECT_TRUE(ohm::render_pass::test_creation());
   EXPECT_TRUE(ohm::render_pass::test_images());
@@ -476,12 +1008,23 @@ TEST(Vulkan, Commands) {
   EXPECT_TRUE(ohm::commands::test_gpu_array_copy());
   EXPECT_TRUE(ohm::commands::test_array_to_image_copy());
   EXPECT_TRUE(ohm::commands::test_image_copy());
+  EXPECT_TRUE(ohm::commands::test_region_array_copy());
+  EXPECT_TRUE(ohm::commands::test_region_image_copy());
+  EXPECT_TRUE(ohm::commands::test_fill_and_update());
+  EXPECT_TRUE(ohm::commands::test_indirect_dispatch());
+  EXPECT_TRUE(ohm::commands::test_redundant_binds());
+  EXPECT_TRUE(ohm::commands::test_profiling_scopes());
+}
+
+TEST(Vulkan, Graph) {
+  EXPECT_TRUE(ohm::graph::test_culling_and_aliasing());
 }
 
 auto main(int argc, char* argv[]) -> int {
   ohm::System<ohm::API>::setDebugParameter("VK_LAYER_KHRONOS_validation");
   ohm::System<ohm::API>::setDebugParameter(
       "VK_LAYER_LUNARG_standard_validation");
+  ohm::System<ohm::API>::setBindless(true);
   ohm::System<ohm::API>::initialize();
   testing::InitGoogleTest(&argc, argv);
   auto success = RUN_ALL_TESTS();
@@ -40,6 +40,7 @@ Buffer::Buffer(Device& device, size_t count, size_t size) {
   this->m_flags |= vk::BufferUsageFlagBits::eUniformBuffer;
   this->m_flags |= vk::BufferUsageFlagBits::eIndexBuffer;
   this->m_flags |= vk::BufferUsageFlagBits::eVertexBuffer;
+  this->m_flags |= vk::BufferUsageFlagBits::eIndirectBuffer;
   this->m_flags |= vk::BufferUsageFlagBits::eTransferSrc;
   this->m_flags |= vk::BufferUsageFlagBits::eTransferDst;
 
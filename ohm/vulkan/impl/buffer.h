@@ -17,6 +17,7 @@ struct Buffer {
   auto operator=(Buffer&& mv) -> Buffer&;
   auto bind(Memory& memory) -> void;
   inline auto initialized() const -> bool { return this->buffer(); }
+  inline auto device() const -> const Device& { return *this->m_device; }
   inline auto count() const -> size_t { return this->m_count; }
   inline auto size() const -> size_t { return this->m_requirements.size; }
   inline auto elementSize() const -> size_t { return this->m_element_size; }
@@ -13,13 +13,16 @@
 #include <map>
 #include <vector>
 #include "ohm/api/exception.h"
+#include "ohm/io/trace.h"
 #include "ohm/vulkan/impl/buffer.h"
 #include "ohm/vulkan/impl/descriptor.h"
+#include "ohm/vulkan/impl/descriptor_heap.h"
 #include "ohm/vulkan/impl/device.h"
 #include "ohm/vulkan/impl/error.h"
 #include "ohm/vulkan/impl/image.h"
 #include "ohm/vulkan/impl/memory.h"
 #include "ohm/vulkan/impl/pipeline.h"
+#include "ohm/vulkan/impl/profiler.h"
 #include "ohm/vulkan/impl/swapchain.h"
 #include "system.h"
 namespace ohm {
@@ -59,6 +62,8 @@ CommandBuffer::CommandBuffer() {
   this->m_recording = false;
   this->m_current_id = 0;
   this->m_render_pass = nullptr;
+  this->m_pipeline = nullptr;
+  this->m_skipped_binds = 0;
   this->m_dirty = false;
   this->m_dependency = nullptr;
   this->m_depended = false;
@@ -74,6 +79,8 @@ CommandBuffer::CommandBuffer(Device& device, QueueType type) {
   this->m_recording = false;
   this->m_current_id = 0;
   this->m_render_pass = nullptr;
+  this->m_pipeline = nullptr;
+  this->m_skipped_binds = 0;
   this->m_dirty = false;
   this->m_dependency = nullptr;
   this->m_depended = false;
@@ -104,12 +111,7 @@ CommandBuffer::CommandBuffer(Device& device, QueueType type) {
   this->m_sync_info.resize(BUFFER_COUNT);
 
   for (auto& sync : this->m_sync_info) {
-    vk::FenceCreateInfo fence_info;
-    fence_info.setFlags(vk::FenceCreateFlagBits::eSignaled);
-
-    sync.fence = error(this->m_device->device().createFence(
-        fence_info, this->m_device->allocationCB(),
-        this->m_device->dispatch()));
+    sync.fence = this->m_device->fence();
     sync.semaphore = error(this->m_device->device().createSemaphore(
         {}, this->m_device->allocationCB(), this->m_device->dispatch()));
   }
@@ -132,6 +134,8 @@ CommandBuffer::CommandBuffer(CommandBuffer& cmd) {
   this->m_queue = cmd.m_queue;
   this->m_vk_pool = cmd.m_vk_pool;
   this->m_render_pass = cmd.m_render_pass;
+  this->m_pipeline = nullptr;
+  this->m_skipped_binds = 0;
   this->m_parent = &cmd;
 
   info.setCommandBufferCount(BUFFER_COUNT);
@@ -141,12 +145,7 @@ CommandBuffer::CommandBuffer(CommandBuffer& cmd) {
   this->m_sync_info.resize(BUFFER_COUNT);
 
   for (auto& sync : this->m_sync_info) {
-    vk::FenceCreateInfo fence_info;
-    fence_info.setFlags(vk::FenceCreateFlagBits::eSignaled);
-
-    sync.fence = error(this->m_device->device().createFence(
-        fence_info, this->m_device->allocationCB(),
-        this->m_device->dispatch()));
+    sync.fence = this->m_device->fence();
     sync.semaphore = error(this->m_device->device().createSemaphore(
         {}, this->m_device->allocationCB(), this->m_device->dispatch()));
   }
@@ -161,20 +160,25 @@ CommandBuffer::CommandBuffer(CommandBuffer&& mv) { *this = std::move(mv); }
 CommandBuffer::~CommandBuffer() {
   if (this->initialized()) {
     this->synchronize();
+    this->m_profiler.reset();
     auto device = this->m_device->device();
     if (this->m_cmd_buffers.size() != 0)
       device.freeCommandBuffers(this->m_vk_pool, this->m_cmd_buffers.size(),
                                 this->m_cmd_buffers.data(),
                                 this->m_device->dispatch());
+    // Synchronized, so every fence is signaled. They go back to the device
+    // rather than being destroyed, as pipelines may still track them.
     for (auto& fence : this->m_sync_info) {
-      device.destroy(fence.fence, this->m_device->allocationCB(),
-                     this->m_device->dispatch());
+      this->m_device->recycle(fence.fence);
       device.destroy(fence.semaphore, this->m_device->allocationCB(),
                      this->m_device->dispatch());
     }
 
     this->m_device = nullptr;
     this->m_render_pass = nullptr;
+    this->m_pipeline = nullptr;
+    this->m_bound = BoundState();
+    this->m_skipped_binds = 0;
     this->m_dependency = nullptr;
     this->m_queue = nullptr;
     this->m_subpass_flags = vk::SubpassContents();
@@ -198,6 +202,10 @@ CommandBuffer::~CommandBuffer() {
 auto CommandBuffer::operator=(CommandBuffer&& mv) -> CommandBuffer& {
   this->m_device = mv.m_device;
   this->m_render_pass = mv.m_render_pass;
+  this->m_pipeline = mv.m_pipeline;
+  this->m_bound = mv.m_bound;
+  this->m_skipped_binds = mv.m_skipped_binds;
+  this->m_profiler = std::move(mv.m_profiler);
   this->m_dependency = mv.m_dependency;
   this->m_queue = mv.m_queue;
   this->m_subpass_flags = mv.m_subpass_flags;
@@ -217,6 +225,9 @@ auto CommandBuffer::operator=(CommandBuffer&& mv) -> CommandBuffer& {
 
   mv.m_device = nullptr;
   mv.m_render_pass = nullptr;
+  mv.m_pipeline = nullptr;
+  mv.m_bound = BoundState();
+  mv.m_skipped_binds = 0;
   mv.m_dependency = nullptr;
   mv.m_queue = nullptr;
   mv.m_subpass_flags = vk::SubpassContents();
@@ -252,9 +263,23 @@ auto CommandBuffer::record() -> void {
                 "begin()/end() combo in the parent's begin()/end() combo.");
     }
 
+    if (this->m_profiler) {
+      for (auto index = 0u; index < this->m_cmd_buffers.size(); index++)
+        this->m_profiler->resolve(index);
+      this->m_profiler->clear();
+    }
+
     for (auto& cmd : this->m_cmd_buffers) {
       error(cmd.begin(this->m_begin_info, this->m_device->dispatch()));
     }
+
+    if (this->m_profiler) {
+      for (auto index = 0u; index < this->m_cmd_buffers.size(); index++)
+        this->m_profiler->reset(this->m_cmd_buffers[index], index);
+    }
+    this->m_pipeline = nullptr;
+    this->m_bound = BoundState();
+    this->m_skipped_binds = 0;
   }
   this->m_recording = true;
 }
@@ -287,6 +312,7 @@ auto CommandBuffer::previousID() -> unsigned {
 }
 
 auto CommandBuffer::unsafe_synchronize() -> void {
+  OhmTraceZone("CommandBuffer::wait");
   auto& device = *this->m_device;
   for (auto& sync : this->m_sync_info) {
     error(device.device().waitForFences(1, &sync.fence, true, UINT64_MAX,
@@ -463,6 +489,254 @@ auto CommandBuffer::copy(Image& src, Image& dst, size_t) -> void {
   this->m_dirty = true;
 }
 
+/** Helpers to turn the API's region descriptions into Vulkan copy regions.
+ * Extents of zero stretch to the end of the requested mip level.
+ */
+static auto mipExtent(size_t size, size_t mip) -> size_t {
+  return std::max<size_t>(size >> mip, 1);
+}
+
+/** Bytes of one texel as copied to and from arrays. Depth images copy their
+ * depth aspect, which is packed into 4 bytes.
+ */
+inline static auto texelSize(ImageFormat format) -> size_t {
+  switch (format) {
+    case ImageFormat::R8:
+      return 1;
+    case ImageFormat::RGB8:
+    case ImageFormat::BGR8:
+      return 3;
+    case ImageFormat::R32U:
+    case ImageFormat::R32I:
+    case ImageFormat::R32F:
+    case ImageFormat::RGBA8:
+    case ImageFormat::BGRA8:
+    case ImageFormat::Depth:
+      return 4;
+    case ImageFormat::RG32F:
+      return 8;
+    case ImageFormat::RGB32U:
+    case ImageFormat::RGB32I:
+    case ImageFormat::RGB32F:
+      return 12;
+    default:
+      return 16;
+  }
+}
+
+static auto subresource(const Image& image, size_t layer, size_t layer_count,
+                        size_t mip) -> vk::ImageSubresourceLayers {
+  auto sub = image.subresource();
+  sub.setBaseArrayLayer(sub.baseArrayLayer + layer);
+  sub.setLayerCount(layer_count);
+  sub.setMipLevel(mip);
+  return sub;
+}
+
+static auto convert(const Buffer& buffer, const Image& image,
+                    const ImageRegion& region) -> vk::BufferImageCopy {
+  auto copy = vk::BufferImageCopy();
+  auto width = mipExtent(image.width(), region.mip);
+  auto height = mipExtent(image.height(), region.mip);
+
+  OhmAssert(region.x >= width || region.y >= height,
+            "Attempting to copy outside of the image's bounds.");
+  OhmAssert(region.layer + region.layer_count > image.layers(),
+            "Attempting to copy outside of the image's layers.");
+
+  width = region.width == 0 ? width - region.x : region.width;
+  height = region.height == 0 ? height - region.y : region.height;
+
+  OhmAssert(region.x + width > mipExtent(image.width(), region.mip) ||
+                region.y + height > mipExtent(image.height(), region.mip),
+            "Attempting to copy past the edge of the image.");
+  OhmAssert(region.array_offset * buffer.elementSize() +
+                    width * height * region.layer_count *
+                        texelSize(image.ohm_format()) >
+                buffer.size(),
+            "Attempting to copy a region larger than the array holds.");
+
+  copy.setBufferOffset(region.array_offset * buffer.elementSize());
+  copy.setBufferRowLength(0);
+  copy.setBufferImageHeight(0);
+  copy.setImageOffset({static_cast<int32_t>(region.x),
+                       static_cast<int32_t>(region.y), 0});
+  copy.setImageExtent({static_cast<uint32_t>(width),
+                       static_cast<uint32_t>(height), 1});
+  copy.setImageSubresource(
+      subresource(image, region.layer, region.layer_count, region.mip));
+  return copy;
+}
+
+auto CommandBuffer::copy(const Buffer& src, Buffer& dst,
+                         const ArrayRegion* regions, size_t count) -> void {
+  auto& dispatch = this->m_device->dispatch();
+  auto copies = std::vector<vk::BufferCopy>();
+  copies.reserve(count);
+
+  // Vulkan doesn't allow empty copies, so empty regions are skipped.
+  for (auto index = 0u; index < count; index++) {
+    auto& region = regions[index];
+    if (region.count == 0) continue;
+
+    auto size = region.count * src.elementSize();
+    auto src_offset = region.src_offset * src.elementSize();
+    auto dst_offset = region.dst_offset * dst.elementSize();
+
+    OhmAssert(src_offset + size > src.size(),
+              "Attempting to copy past the end of the source array.");
+    OhmAssert(dst_offset + size > dst.size(),
+              "Attempting to copy past the end of the destination array.");
+
+    copies.push_back(vk::BufferCopy(src_offset, dst_offset, size));
+  }
+
+  if (copies.empty()) return;
+
+  auto lock = std::unique_lock<std::mutex>(this->m_lock);
+  OhmAssert(!this->m_recording,
+            "Attempting to record to a command buffer without starting a "
+            "record operation.");
+  auto function = [&copies, &src, &dst, &dispatch](vk::CommandBuffer& cmd,
+                                                   size_t) {
+    cmd.copyBuffer(src.buffer(), dst.buffer(), copies.size(), copies.data(),
+                   dispatch);
+  };
+
+  this->append(function);
+  this->m_dirty = true;
+}
+
+auto CommandBuffer::copy(const Buffer& src, Image& dst,
+                         const ImageRegion* regions, size_t count) -> void {
+  auto copies = std::vector<vk::BufferImageCopy>(count);
+  for (auto index = 0u; index < count; index++) {
+    copies[index] = convert(src, dst, regions[index]);
+  }
+
+  if (copies.empty()) return;
+
+  std::unique_lock<std::mutex> lock(this->m_lock);
+  OhmAssert(!this->m_recording,
+            "Attempting to record to a command buffer without starting a "
+            "record operation.");
+
+  auto function = [&src, &dst, &copies, this](vk::CommandBuffer& cmd, size_t) {
+    cmd.copyBufferToImage(src.buffer(), dst.image(), vk::ImageLayout::eGeneral,
+                          copies.size(), copies.data(),
+                          this->m_device->dispatch());
+  };
+
+  auto dst_old_layout = dst.layout();
+
+  if (dst.layout() != vk::ImageLayout::eGeneral)
+    this->transition(dst, vk::ImageLayout::eGeneral);
+
+  this->append(function);
+
+  if (dst_old_layout != vk::ImageLayout::eUndefined)
+    this->transition(dst, dst_old_layout);
+
+  this->m_dirty = true;
+}
+
+auto CommandBuffer::copy(Image& src, Buffer& dst, const ImageRegion* regions,
+                         size_t count) -> void {
+  auto copies = std::vector<vk::BufferImageCopy>(count);
+  for (auto index = 0u; index < count; index++) {
+    copies[index] = convert(dst, src, regions[index]);
+  }
+
+  if (copies.empty()) return;
+
+  auto function = [&src, &dst, &copies, this](vk::CommandBuffer& cmd, size_t) {
+    cmd.copyImageToBuffer(src.image(), vk::ImageLayout::eGeneral, dst.buffer(),
+                          copies.size(), copies.data(),
+                          this->m_device->dispatch());
+  };
+
+  std::unique_lock<std::mutex> lock(this->m_lock);
+  OhmAssert(!this->m_recording,
+            "Attempting to record to a command buffer without starting a "
+            "record operation.");
+
+  auto src_old_layout = src.layout();
+
+  if (src.layout() != vk::ImageLayout::eGeneral)
+    this->transition(src, vk::ImageLayout::eGeneral);
+
+  this->append(function);
+
+  if (src_old_layout != vk::ImageLayout::eUndefined)
+    this->transition(src, src_old_layout);
+
+  this->m_dirty = true;
+}
+
+auto CommandBuffer::copy(Image& src, Image& dst, const ImageCopyRegion* regions,
+                         size_t count) -> void {
+  auto copies = std::vector<vk::ImageCopy>(count);
+
+  for (auto index = 0u; index < count; index++) {
+    auto& region = regions[index];
+    auto width = mipExtent(src.width(), region.src_mip);
+    auto height = mipExtent(src.height(), region.src_mip);
+
+    OhmAssert(region.src_x >= width || region.src_y >= height,
+              "Attempting to copy outside of the source image's bounds.");
+    OhmAssert(region.src_layer + region.layer_count > src.layers(),
+              "Attempting to copy outside of the source image's layers.");
+    OhmAssert(region.dst_layer + region.layer_count > dst.layers(),
+              "Attempting to copy outside of the destination image's layers.");
+
+    width = region.width == 0 ? width - region.src_x : region.width;
+    height = region.height == 0 ? height - region.src_y : region.height;
+
+    OhmAssert(region.src_x + width > mipExtent(src.width(), region.src_mip) ||
+                  region.src_y + height > mipExtent(src.height(), region.src_mip),
+              "Attempting to copy past the edge of the source image.");
+    OhmAssert(region.dst_x + width > mipExtent(dst.width(), region.dst_mip) ||
+                  region.dst_y + height > mipExtent(dst.height(), region.dst_mip),
+              "Attempting to copy past the edge of the destination image.");
+
+    copies[index].setSrcOffset({static_cast<int32_t>(region.src_x),
+                                static_cast<int32_t>(region.src_y), 0});
+    copies[index].setDstOffset({static_cast<int32_t>(region.dst_x),
+                                static_cast<int32_t>(region.dst_y), 0});
+    copies[index].setExtent({static_cast<uint32_t>(width),
+                             static_cast<uint32_t>(height), 1});
+    copies[index].setSrcSubresource(subresource(
+        src, region.src_layer, region.layer_count, region.src_mip));
+    copies[index].setDstSubresource(subresource(
+        dst, region.dst_layer, region.layer_count, region.dst_mip));
+  }
+
+  if (copies.empty()) return;
+
+  auto lock = std::unique_lock<std::mutex>(this->m_lock);
+  OhmAssert(!this->m_recording,
+            "Attempting to record to a command buffer without starting a "
+            "record operation.");
+
+  auto function = [&src, &dst, &copies, this](vk::CommandBuffer& cmd, size_t) {
+    cmd.copyImage(src.image(), src.layout(), dst.image(), dst.layout(),
+                  copies.size(), copies.data(), this->m_device->dispatch());
+  };
+
+  auto src_old_layout = src.layout();
+  auto dst_old_layout = dst.layout();
+
+  this->transition(src, vk::ImageLayout::eGeneral);
+  this->transition(dst, vk::ImageLayout::eGeneral);
+  this->append(function);
+  if (src_old_layout != vk::ImageLayout::eUndefined)
+    this->transition(src, src_old_layout);
+  if (dst_old_layout != vk::ImageLayout::eUndefined)
+    this->transition(dst, dst_old_layout);
+
+  this->m_dirty = true;
+}
+
 auto CommandBuffer::clearDependancies() -> void {
   this->m_dependancies.clear();
 }
@@ -472,6 +746,7 @@ auto CommandBuffer::addDependancy(vk::Semaphore semaphore) -> void {
 }
 
 auto CommandBuffer::bind(Descriptor& desc) -> void {
+  desc.commit();
   auto& pipeline = desc.pipeline();
   auto vk_pipe = pipeline.pipeline();
   auto layout = pipeline.layout();
@@ -479,19 +754,39 @@ auto CommandBuffer::bind(Descriptor& desc) -> void {
   const auto bind_point = pipeline.graphics() ? vk::PipelineBindPoint::eGraphics
                                               : vk::PipelineBindPoint::eCompute;
 
-  auto function = [&bind_point, &vk_pipe, &desc, &layout, &dispatch, this](
-                      vk::CommandBuffer& cmd, size_t) {
-    cmd.bindPipeline(bind_point, vk_pipe, this->m_device->dispatch());
-    if (desc.set())
-      cmd.bindDescriptorSets(bind_point, layout, 0, 1, &desc.set(), 0, nullptr,
-                             dispatch);
-  };
-
   auto lock = std::unique_lock<std::mutex>(this->m_lock);
   OhmAssert(!this->m_recording,
             "Attempting to record to a command buffer without starting a "
             "record operation.");
-  this->append(function);
+
+  // Every buffer of the ring records the set, and secondary ones run under
+  // their parent's submits, so freeing it waits on all of those.
+  auto& owner = this->m_parent ? *this->m_parent : *this;
+  for (auto& sync : owner.m_sync_info) desc.use(sync.fence);
+
+  const auto bind_pipeline = this->needsPipelineBind(bind_point, vk_pipe);
+  const auto bind_set =
+      desc.set() && this->needsSetBind(bind_point, layout, desc.set());
+
+  // The heap is bound with the pipeline's set, so a layout change that
+  // disturbs one rebinds both.
+  auto* heap = pipeline.device().heap();
+  const auto sets = std::array<vk::DescriptorSet, 2>{
+      desc.set(), heap ? heap->set() : vk::DescriptorSet()};
+  const auto set_count = heap ? 2u : 1u;
+
+  auto function = [&bind_point, &vk_pipe, &sets, &set_count, &layout,
+                   &dispatch, &bind_pipeline, &bind_set,
+                   this](vk::CommandBuffer& cmd, size_t) {
+    if (bind_pipeline)
+      cmd.bindPipeline(bind_point, vk_pipe, this->m_device->dispatch());
+    if (bind_set)
+      cmd.bindDescriptorSets(bind_point, layout, 0, set_count, sets.data(), 0,
+                             nullptr, dispatch);
+  };
+
+  if (bind_pipeline || bind_set) this->append(function);
+  this->m_pipeline = &pipeline;
   this->m_dirty = true;
 }
 
@@ -623,6 +918,9 @@ auto CommandBuffer::combine(CommandBuffer& child) -> void {
 
   this->append(function);
 
+  // Executing secondary command buffers leaves the bound state undefined.
+  this->m_bound = BoundState();
+
   this->m_dirty = true;
 }
 
@@ -637,9 +935,13 @@ auto CommandBuffer::draw(const Buffer& vertices, unsigned instance_count)
   const auto& offset = vertices.memory().offset;
   const auto& buffer = vertices.buffer();
 
-  auto function = [&buffer, &offset, this, &instance_count, &vertices](
-                      vk::CommandBuffer& cmd, size_t) {
-    cmd.bindVertexBuffers(0, 1, &buffer, &offset, this->m_device->dispatch());
+  const auto bind_vertices = this->needsVertexBind(buffer, offset);
+
+  auto function = [&buffer, &offset, this, &instance_count, &vertices,
+                   &bind_vertices](vk::CommandBuffer& cmd, size_t) {
+    if (bind_vertices)
+      cmd.bindVertexBuffers(0, 1, &buffer, &offset,
+                            this->m_device->dispatch());
     cmd.draw(vertices.count(), instance_count, 0, 0,
              this->m_device->dispatch());
   };
@@ -658,12 +960,19 @@ auto CommandBuffer::draw(const Buffer& indices, const Buffer& vertices,
   const auto& vertex_buffer = vertices.buffer();
   const auto& index_buffer = indices.buffer();
 
+  const auto bind_vertices =
+      this->needsVertexBind(vertex_buffer, vertex_offset);
+  const auto bind_indices = this->needsIndexBind(index_buffer);
+
   auto function = [&vertex_buffer, &instance_count, &indices, &index_buffer,
-                   &vertex_offset, this](vk::CommandBuffer& cmd, size_t) {
-    cmd.bindVertexBuffers(0, 1, &vertex_buffer, &vertex_offset,
+                   &vertex_offset, &bind_vertices, &bind_indices,
+                   this](vk::CommandBuffer& cmd, size_t) {
+    if (bind_vertices)
+      cmd.bindVertexBuffers(0, 1, &vertex_buffer, &vertex_offset,
+                            this->m_device->dispatch());
+    if (bind_indices)
+      cmd.bindIndexBuffer(index_buffer, 0, vk::IndexType::eUint32,
                           this->m_device->dispatch());
-    cmd.bindIndexBuffer(index_buffer, 0, vk::IndexType::eUint32,
-                        this->m_device->dispatch());
     cmd.drawIndexed(indices.count(), instance_count, 0, 0, 0,
                     this->m_device->dispatch());
   };
@@ -678,6 +987,218 @@ auto CommandBuffer::draw(const Buffer& indices, const Buffer& vertices,
   this->m_dirty = true;
 }
 
+auto CommandBuffer::drawIndirect(const Buffer& vertices, const Buffer& args,
+                                 unsigned draw_count, size_t offset) -> void {
+  auto lock = std::unique_lock<std::mutex>(this->m_lock);
+  const auto& vertex_offset = vertices.memory().offset;
+  const auto& vertex_buffer = vertices.buffer();
+  const auto& args_buffer = args.buffer();
+  const auto stride = static_cast<uint32_t>(args.elementSize());
+  const auto byte_offset = offset * args.elementSize();
+
+  const auto bind_vertices =
+      this->needsVertexBind(vertex_buffer, vertex_offset);
+
+  auto function = [&](vk::CommandBuffer& cmd, size_t) {
+    if (bind_vertices)
+      cmd.bindVertexBuffers(0, 1, &vertex_buffer, &vertex_offset,
+                            this->m_device->dispatch());
+    cmd.drawIndirect(args_buffer, byte_offset, draw_count, stride,
+                     this->m_device->dispatch());
+  };
+
+  OhmAssert(!this->m_recording,
+            "Attempting to record to a command buffer without starting a "
+            "record operation.");
+  OhmAssert(
+      draw_count > 1 && !this->m_device->enabledFeatures().multiDrawIndirect,
+      "Issuing several indirect draws at once needs the device's "
+      "multiDrawIndirect feature.");
+  this->append(function);
+  this->m_dirty = true;
+}
+
+auto CommandBuffer::drawIndirect(const Buffer& vertices, const Buffer& args,
+                                 const Buffer& count, unsigned max_draws)
+    -> void {
+  auto lock = std::unique_lock<std::mutex>(this->m_lock);
+  const auto& vertex_offset = vertices.memory().offset;
+  const auto& vertex_buffer = vertices.buffer();
+  const auto& args_buffer = args.buffer();
+  const auto& count_buffer = count.buffer();
+  const auto& count_offset = count.memory().offset;
+  const auto stride = static_cast<uint32_t>(args.elementSize());
+  const auto has_count =
+      this->m_device->supports(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+
+  const auto bind_vertices =
+      this->needsVertexBind(vertex_buffer, vertex_offset);
+
+  // Without the count extension we can only issue every draw up to the max,
+  // so unused records are expected to have an instance count of zero.
+  auto function = [&](vk::CommandBuffer& cmd, size_t) {
+    if (bind_vertices)
+      cmd.bindVertexBuffers(0, 1, &vertex_buffer, &vertex_offset,
+                            this->m_device->dispatch());
+    if (has_count)
+      cmd.drawIndirectCountKHR(args_buffer, 0, count_buffer, count_offset,
+                               max_draws, stride, this->m_device->dispatch());
+    else
+      cmd.drawIndirect(args_buffer, 0, max_draws, stride,
+                       this->m_device->dispatch());
+  };
+
+  OhmAssert(!this->m_recording,
+            "Attempting to record to a command buffer without starting a "
+            "record operation.");
+  OhmAssert(
+      max_draws > 1 && !this->m_device->enabledFeatures().multiDrawIndirect,
+      "Issuing several indirect draws at once needs the device's "
+      "multiDrawIndirect feature.");
+  this->append(function);
+  this->m_dirty = true;
+}
+
+auto CommandBuffer::drawIndexedIndirect(const Buffer& indices,
+                                        const Buffer& vertices,
+                                        const Buffer& args, unsigned draw_count,
+                                        size_t offset) -> void {
+  auto lock = std::unique_lock<std::mutex>(this->m_lock);
+  const auto& vertex_offset = vertices.memory().offset;
+  const auto& vertex_buffer = vertices.buffer();
+  const auto& index_buffer = indices.buffer();
+  const auto& args_buffer = args.buffer();
+  const auto stride = static_cast<uint32_t>(args.elementSize());
+  const auto byte_offset = offset * args.elementSize();
+
+  const auto bind_vertices =
+      this->needsVertexBind(vertex_buffer, vertex_offset);
+  const auto bind_indices = this->needsIndexBind(index_buffer);
+
+  auto function = [&](vk::CommandBuffer& cmd, size_t) {
+    if (bind_vertices)
+      cmd.bindVertexBuffers(0, 1, &vertex_buffer, &vertex_offset,
+                            this->m_device->dispatch());
+    if (bind_indices)
+      cmd.bindIndexBuffer(index_buffer, 0, vk::IndexType::eUint32,
+                          this->m_device->dispatch());
+    cmd.drawIndexedIndirect(args_buffer, byte_offset, draw_count, stride,
+                            this->m_device->dispatch());
+  };
+
+  OhmAssert(!this->m_recording,
+            "Attempting to record to a command buffer without starting a "
+            "record operation.");
+  OhmAssert(
+      draw_count > 1 && !this->m_device->enabledFeatures().multiDrawIndirect,
+      "Issuing several indirect draws at once needs the device's "
+      "multiDrawIndirect feature.");
+  this->append(function);
+  this->m_dirty = true;
+}
+
+auto CommandBuffer::drawIndexedIndirect(const Buffer& indices,
+                                        const Buffer& vertices,
+                                        const Buffer& args, const Buffer& count,
+                                        unsigned max_draws) -> void {
+  auto lock = std::unique_lock<std::mutex>(this->m_lock);
+  const auto& vertex_offset = vertices.memory().offset;
+  const auto& vertex_buffer = vertices.buffer();
+  const auto& index_buffer = indices.buffer();
+  const auto& args_buffer = args.buffer();
+  const auto& count_buffer = count.buffer();
+  const auto& count_offset = count.memory().offset;
+  const auto stride = static_cast<uint32_t>(args.elementSize());
+  const auto has_count =
+      this->m_device->supports(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+
+  const auto bind_vertices =
+      this->needsVertexBind(vertex_buffer, vertex_offset);
+  const auto bind_indices = this->needsIndexBind(index_buffer);
+
+  auto function = [&](vk::CommandBuffer& cmd, size_t) {
+    if (bind_vertices)
+      cmd.bindVertexBuffers(0, 1, &vertex_buffer, &vertex_offset,
+                            this->m_device->dispatch());
+    if (bind_indices)
+      cmd.bindIndexBuffer(index_buffer, 0, vk::IndexType::eUint32,
+                          this->m_device->dispatch());
+    if (has_count)
+      cmd.drawIndexedIndirectCountKHR(args_buffer, 0, count_buffer,
+                                      count_offset, max_draws, stride,
+                                      this->m_device->dispatch());
+    else
+      cmd.drawIndexedIndirect(args_buffer, 0, max_draws, stride,
+                              this->m_device->dispatch());
+  };
+
+  OhmAssert(!this->m_recording,
+            "Attempting to record to a command buffer without starting a "
+            "record operation.");
+  OhmAssert(
+      max_draws > 1 && !this->m_device->enabledFeatures().multiDrawIndirect,
+      "Issuing several indirect draws at once needs the device's "
+      "multiDrawIndirect feature.");
+  this->append(function);
+  this->m_dirty = true;
+}
+
+auto CommandBuffer::needsPipelineBind(vk::PipelineBindPoint point,
+                                      vk::Pipeline pipeline) -> bool {
+  auto& bound = point == vk::PipelineBindPoint::eGraphics
+                    ? this->m_bound.graphics_pipeline
+                    : this->m_bound.compute_pipeline;
+  if (bound == pipeline) {
+    this->m_skipped_binds++;
+    return false;
+  }
+
+  bound = pipeline;
+  return true;
+}
+
+auto CommandBuffer::needsSetBind(vk::PipelineBindPoint point,
+                                 vk::PipelineLayout layout,
+                                 vk::DescriptorSet set) -> bool {
+  const auto graphics = point == vk::PipelineBindPoint::eGraphics;
+  auto& bound_layout =
+      graphics ? this->m_bound.graphics_layout : this->m_bound.compute_layout;
+  auto& bound_set =
+      graphics ? this->m_bound.graphics_set : this->m_bound.compute_set;
+
+  if (bound_layout == layout && bound_set == set) {
+    this->m_skipped_binds++;
+    return false;
+  }
+
+  bound_layout = layout;
+  bound_set = set;
+  return true;
+}
+
+auto CommandBuffer::needsVertexBind(vk::Buffer buffer, vk::DeviceSize offset)
+    -> bool {
+  if (this->m_bound.vertices == buffer &&
+      this->m_bound.vertex_offset == offset) {
+    this->m_skipped_binds++;
+    return false;
+  }
+
+  this->m_bound.vertices = buffer;
+  this->m_bound.vertex_offset = offset;
+  return true;
+}
+
+auto CommandBuffer::needsIndexBind(vk::Buffer buffer) -> bool {
+  if (this->m_bound.indices == buffer) {
+    this->m_skipped_binds++;
+    return false;
+  }
+
+  this->m_bound.indices = buffer;
+  return true;
+}
+
 auto CommandBuffer::dispatch(size_t x, size_t y, size_t z) -> void {
   auto lock = std::unique_lock<std::mutex>(this->m_lock);
 
@@ -692,6 +1213,178 @@ auto CommandBuffer::dispatch(size_t x, size_t y, size_t z) -> void {
   this->m_dirty = true;
 }
 
+auto CommandBuffer::dispatchIndirect(const Buffer& args, size_t offset)
+    -> void {
+  auto lock = std::unique_lock<std::mutex>(this->m_lock);
+  const auto& args_buffer = args.buffer();
+  const auto byte_offset = offset * args.elementSize();
+
+  auto function = [&args_buffer, &byte_offset, this](vk::CommandBuffer& cmd,
+                                                     size_t) {
+    cmd.dispatchIndirect(args_buffer, byte_offset, this->m_device->dispatch());
+  };
+
+  OhmAssert(!this->m_recording,
+            "Attempting to record to a command buffer without starting a "
+            "record operation.");
+  this->append(function);
+  this->m_dirty = true;
+}
+
+auto CommandBuffer::fill(Buffer& dst, uint32_t value, size_t offset,
+                         size_t count) -> void {
+  auto& dispatch = this->m_device->dispatch();
+  const auto byte_offset = offset * dst.elementSize();
+  const auto size = count == 0 ? static_cast<vk::DeviceSize>(VK_WHOLE_SIZE)
+                               : count * dst.elementSize();
+
+  OhmAssert(byte_offset % 4 != 0 || (count != 0 && size % 4 != 0),
+            "Attempting to fill a range that is not 4-byte aligned.");
+
+  auto function = [&dst, &byte_offset, &size, &value, &dispatch](
+                      vk::CommandBuffer& cmd, size_t) {
+    cmd.fillBuffer(dst.buffer(), byte_offset, size, value, dispatch);
+  };
+
+  auto lock = std::unique_lock<std::mutex>(this->m_lock);
+  OhmAssert(!this->m_recording,
+            "Attempting to record to a command buffer without starting a "
+            "record operation.");
+  this->append(function);
+  this->m_dirty = true;
+}
+
+auto CommandBuffer::update(Buffer& dst, const void* src, size_t count,
+                           size_t offset) -> void {
+  constexpr auto max_update_size = 65536u;
+  auto& dispatch = this->m_device->dispatch();
+  const auto byte_offset = offset * dst.elementSize();
+  const auto size = count * dst.elementSize();
+
+  OhmAssert(size > max_update_size,
+            "Attempting to inline update more than 65536 bytes. Use a copy "
+            "instead.");
+  OhmAssert(byte_offset % 4 != 0 || size % 4 != 0,
+            "Attempting to update a range that is not 4-byte aligned.");
+
+  auto function = [&dst, &byte_offset, &size, &src, &dispatch](
+                      vk::CommandBuffer& cmd, size_t) {
+    cmd.updateBuffer(dst.buffer(), byte_offset, size, src, dispatch);
+  };
+
+  auto lock = std::unique_lock<std::mutex>(this->m_lock);
+  OhmAssert(!this->m_recording,
+            "Attempting to record to a command buffer without starting a "
+            "record operation.");
+  this->append(function);
+  this->m_dirty = true;
+  (void)max_update_size;
+}
+
+auto CommandBuffer::barrier() -> void {
+  auto& dispatch = this->m_device->dispatch();
+  auto barrier = vk::MemoryBarrier();
+  const auto stage = vk::PipelineStageFlagBits::eAllCommands;
+
+  barrier.setSrcAccessMask(vk::AccessFlagBits::eMemoryWrite);
+  barrier.setDstAccessMask(vk::AccessFlagBits::eMemoryRead |
+                           vk::AccessFlagBits::eMemoryWrite);
+
+  auto function = [&barrier, &stage, &dispatch](vk::CommandBuffer& cmd,
+                                                size_t) {
+    cmd.pipelineBarrier(stage, stage, {}, 1, &barrier, 0, nullptr, 0, nullptr,
+                        dispatch);
+  };
+
+  auto lock = std::unique_lock<std::mutex>(this->m_lock);
+  OhmAssert(!this->m_recording,
+            "Attempting to record to a command buffer without starting a "
+            "record operation.");
+  this->append(function);
+  this->m_dirty = true;
+}
+
+auto CommandBuffer::pushConstants(const void* data, size_t size,
+                                  size_t offset) -> void {
+  auto lock = std::unique_lock<std::mutex>(this->m_lock);
+  OhmAssert(!this->m_recording,
+            "Attempting to record to a command buffer without starting a "
+            "record operation.");
+  OhmAssert(this->m_pipeline == nullptr,
+            "Attempting to push constants without a bound pipeline.");
+  OhmAssert(offset + size > this->m_pipeline->pushConstantSize(),
+            "Attempting to push more constant data than the pipeline's "
+            "push constant block holds.");
+
+  const auto layout = this->m_pipeline->layout();
+  const auto flags = this->m_pipeline->pushConstantFlags();
+
+  auto function = [&layout, &flags, &offset, &size, &data, this](
+                      vk::CommandBuffer& cmd, size_t) {
+    cmd.pushConstants(layout, flags, offset, size, data,
+                      this->m_device->dispatch());
+  };
+
+  this->append(function);
+  this->m_dirty = true;
+}
+
+auto CommandBuffer::profile(bool enable, bool statistics) -> void {
+  auto lock = std::unique_lock<std::mutex>(this->m_lock);
+  OhmAssert(this->m_recording,
+            "Attempting to toggle profiling in the middle of a record "
+            "operation.");
+
+  this->unsafe_synchronize();
+  this->m_profiler.reset();
+  if (enable)
+    this->m_profiler = std::make_unique<Profiler>(
+        *this->m_device, this->m_queue->id, this->m_cmd_buffers.size(),
+        statistics);
+}
+
+auto CommandBuffer::beginScope(std::string_view name) -> void {
+  if (!this->m_profiler) return;
+
+  auto lock = std::unique_lock<std::mutex>(this->m_lock);
+  OhmAssert(!this->m_recording,
+            "Attempting to record to a command buffer without starting a "
+            "record operation.");
+
+  const auto scope = this->m_profiler->push(name);
+  if (scope == MAX_SCOPES) return;
+
+  auto function = [&scope, this](vk::CommandBuffer& cmd, unsigned index) {
+    this->m_profiler->begin(cmd, index, scope);
+  };
+
+  this->append(function);
+}
+
+auto CommandBuffer::endScope() -> void {
+  if (!this->m_profiler) return;
+
+  auto lock = std::unique_lock<std::mutex>(this->m_lock);
+  OhmAssert(!this->m_recording,
+            "Attempting to record to a command buffer without starting a "
+            "record operation.");
+
+  const auto scope = this->m_profiler->pop();
+  if (scope == MAX_SCOPES) return;
+
+  auto function = [&scope, this](vk::CommandBuffer& cmd, unsigned index) {
+    this->m_profiler->end(cmd, index, scope);
+  };
+
+  this->append(function);
+}
+
+auto CommandBuffer::scopes() const -> std::vector<ScopeTiming> {
+  auto lock = std::unique_lock<std::mutex>(this->m_lock);
+  if (!this->m_profiler) return {};
+  return this->m_profiler->results();
+}
+
 auto CommandBuffer::depended() const -> bool { return this->m_depended; }
 
 auto CommandBuffer::setDepended(bool flag) -> void { this->m_depended = flag; }
@@ -792,6 +1485,11 @@ auto CommandBuffer::synchronize() -> void {
   // Lock this command buffer access.
   auto lock1 = std::unique_lock<std::mutex>(this->m_lock);
   this->unsafe_synchronize();
+
+  if (this->m_profiler) {
+    for (auto index = 0u; index < this->m_cmd_buffers.size(); index++)
+      this->m_profiler->resolve(index);
+  }
 }
 
 auto CommandBuffer::submit() -> void {
@@ -805,13 +1503,18 @@ auto CommandBuffer::submit() -> void {
 
   this->unsafe_end();
 
-  error(this->m_device->device().waitForFences(
-      1, &this->m_sync_info[this->m_current_id].fence, true, UINT64_MAX,
-      this->m_device->dispatch()));
+  {
+    OhmTraceZone("CommandBuffer::wait");
+    error(this->m_device->device().waitForFences(
+        1, &this->m_sync_info[this->m_current_id].fence, true, UINT64_MAX,
+        this->m_device->dispatch()));
+  }
   error(this->m_device->device().resetFences(
       1, &this->m_sync_info[this->m_current_id].fence,
       this->m_device->dispatch()));
 
+  if (this->m_profiler) this->m_profiler->resolve(this->m_current_id);
+
   auto buffer = this->current();
 
   if (this->m_dependency != nullptr && this->m_dependency->m_first == false) {
@@ -839,6 +1542,8 @@ auto CommandBuffer::submit() -> void {
   error(
       this->m_queue->queue.submit(1, &info, fence, this->m_device->dispatch()));
 
+  if (this->m_profiler) this->m_profiler->submitted(this->m_current_id);
+
   this->advance();
   this->m_first = false;
 }
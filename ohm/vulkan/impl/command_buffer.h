@@ -1,5 +1,6 @@
 #pragma once
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <thread>
 #include <unordered_map>
@@ -19,6 +20,7 @@ class Device;
 class Descriptor;
 class CommandBuffer;
 class Swapchain;
+class Profiler;
 
 using Family = unsigned;
 using PoolMap = std::unordered_map<Family, vk::CommandPool>;
@@ -46,6 +48,14 @@ class CommandBuffer {
   auto copy(const Buffer& src, unsigned char* dst, size_t amt = 0) -> void;
   auto copy(const unsigned char* src, Buffer& dst, size_t amt = 0) -> void;
   auto copy(Image& src, Image& dst, size_t amt = 0) -> void;
+  auto copy(const Buffer& src, Buffer& dst, const ArrayRegion* regions,
+            size_t count) -> void;
+  auto copy(const Buffer& src, Image& dst, const ImageRegion* regions,
+            size_t count) -> void;
+  auto copy(Image& src, Buffer& dst, const ImageRegion* regions, size_t count)
+      -> void;
+  auto copy(Image& src, Image& dst, const ImageCopyRegion* regions,
+            size_t count) -> void;
   auto addDependancy(vk::Semaphore semaphore) -> void;
   auto clearDependancies() -> void;
   auto detach() -> void;
@@ -60,7 +70,27 @@ class CommandBuffer {
   auto draw(const Buffer& vertices, unsigned instance_count = 1) -> void;
   auto draw(const Buffer& indices, const Buffer& vertices,
             unsigned instance_count = 1) -> void;
+  auto drawIndirect(const Buffer& vertices, const Buffer& args,
+                    unsigned draw_count = 1, size_t offset = 0) -> void;
+  auto drawIndirect(const Buffer& vertices, const Buffer& args,
+                    const Buffer& count, unsigned max_draws) -> void;
+  auto drawIndexedIndirect(const Buffer& indices, const Buffer& vertices,
+                           const Buffer& args, unsigned draw_count = 1,
+                           size_t offset = 0) -> void;
+  auto drawIndexedIndirect(const Buffer& indices, const Buffer& vertices,
+                           const Buffer& args, const Buffer& count,
+                           unsigned max_draws) -> void;
   auto dispatch(size_t x, size_t y, size_t z = 1) -> void;
+  auto fill(Buffer& dst, uint32_t value, size_t offset = 0, size_t count = 0)
+      -> void;
+  auto update(Buffer& dst, const void* src, size_t count, size_t offset = 0)
+      -> void;
+  auto dispatchIndirect(const Buffer& args, size_t offset = 0) -> void;
+  auto pushConstants(const void* data, size_t size, size_t offset = 0) -> void;
+  auto profile(bool enable, bool statistics = false) -> void;
+  auto beginScope(std::string_view name) -> void;
+  auto endScope() -> void;
+  auto scopes() const -> std::vector<ScopeTiming>;
   auto depended() const -> bool;
   auto setDepended(bool flag) -> void;
   auto end() -> void;
@@ -71,7 +101,7 @@ class CommandBuffer {
   auto synchronize() -> void;
   auto submit() -> void;
   auto present(Swapchain& swapchain) -> bool;
-  auto pipelineBarrier(unsigned src, unsigned dst) -> void;
+  auto barrier() -> void;
   auto wait(CommandBuffer& buffer) -> void;
   auto cmd(unsigned index) -> vk::CommandBuffer;
   inline auto pool() { return this->m_vk_pool; }
@@ -83,7 +113,11 @@ class CommandBuffer {
     return this->m_sync_info[this->m_current_id].fence;
   }
   inline auto fence(unsigned index) { return this->m_sync_info[index].fence; }
+  inline auto submitted() {
+    return this->m_sync_info[this->previousID()].fence;
+  }
   inline auto initialized() const { return !this->m_cmd_buffers.empty(); }
+  inline auto skippedBinds() const { return this->m_skipped_binds; }
 
  private:
   using RecordFunction =
@@ -95,11 +129,27 @@ class CommandBuffer {
     vk::Semaphore semaphore;
   };
 
+  /** The state last bound into the command buffers, used to skip binds that
+   * would not change anything.
+   */
+  struct BoundState {
+    vk::Pipeline graphics_pipeline;
+    vk::Pipeline compute_pipeline;
+    vk::PipelineLayout graphics_layout;
+    vk::PipelineLayout compute_layout;
+    vk::DescriptorSet graphics_set;
+    vk::DescriptorSet compute_set;
+    vk::Buffer vertices;
+    vk::DeviceSize vertex_offset = 0;
+    vk::Buffer indices;
+  };
+
   using CmdBuffers = std::vector<vk::CommandBuffer>;
   using Fences = std::vector<vk::Fence>;
 
   Device* m_device;
   RenderPass* m_render_pass;
+  const Pipeline* m_pipeline;
   CommandBuffer* m_dependency;
   Queue* m_queue;
   vk::SubpassContents m_subpass_flags;
@@ -111,9 +161,12 @@ class CommandBuffer {
   CmdBuffers m_cmd_buffers;
   std::vector<CmdBuffSync> m_sync_info;
   std::vector<vk::Semaphore> m_dependancies;
+  BoundState m_bound;
+  size_t m_skipped_binds;
+  std::unique_ptr<Profiler> m_profiler;
   bool m_recording;
   size_t m_current_id;
-  std::mutex m_lock;
+  mutable std::mutex m_lock;
   bool m_dirty;
   bool m_depended;
   bool m_first;
@@ -133,6 +186,16 @@ class CommandBuffer {
    * @return The currently active command buffer.
    */
 
+  /** Methods to track bound state. Each returns whether the bind needs to be
+   * recorded, and counts the ones that don't.
+   */
+  auto needsPipelineBind(vk::PipelineBindPoint point, vk::Pipeline pipeline)
+      -> bool;
+  auto needsSetBind(vk::PipelineBindPoint point, vk::PipelineLayout layout,
+                    vk::DescriptorSet set) -> bool;
+  auto needsVertexBind(vk::Buffer buffer, vk::DeviceSize offset) -> bool;
+  auto needsIndexBind(vk::Buffer buffer) -> bool;
+
   /** Method to advance the current command buffer.
    */
   auto advance() -> void;
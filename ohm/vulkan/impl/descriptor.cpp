@@ -5,9 +5,12 @@
 #define VULKAN_HPP_NO_EXCEPTIONS
 
 #include "ohm/vulkan/impl/descriptor.h"
+#include <algorithm>
 #include <iostream>
 #include <utility>
 #include <vector>
+#include "ohm/vulkan/impl/descriptor_heap.h"
+#include "ohm/vulkan/impl/device.h"
 #include "ohm/vulkan/impl/error.h"
 #include "ohm/vulkan/impl/pipeline.h"
 
@@ -30,47 +33,90 @@ auto convert(io::VariableType type) -> vk::DescriptorType {
   }
 }
 
+/** Finds a binding ID by its name's hash.
+ */
+template <typename Table>
+inline auto find(const Table& table, uint64_t hash) -> int32_t {
+  auto iter = std::lower_bound(table.ids.begin(), table.ids.end(),
+                               std::make_pair(hash, int32_t(-1)));
+  if (iter == table.ids.end() || iter->first != hash) return -1;
+  return iter->second;
+}
+
+inline auto is_buffer(vk::DescriptorType type) -> bool {
+  return type == vk::DescriptorType::eUniformBuffer ||
+         type == vk::DescriptorType::eStorageBuffer;
+}
+
 DescriptorPool::DescriptorPool() {
   this->m_map = std::make_shared<UniformMap>();
+  this->m_table = std::make_shared<Table>();
   this->m_amount = 20;
-  this->m_pool = nullptr;
+  this->m_device = nullptr;
   this->m_pipeline = nullptr;
 }
 
 DescriptorPool::DescriptorPool(DescriptorPool&& mv) { *this = std::move(mv); }
 
 DescriptorPool::~DescriptorPool() {
-  if (this->m_pool) {
+  if (this->m_device && this->m_table) {
     auto device = this->m_device->device();
     auto* alloc_cb = this->m_device->allocationCB();
     auto& dispatch = this->m_device->dispatch();
-    auto flags = vk::DescriptorPoolResetFlags();
-    device.resetDescriptorPool(this->m_pool, flags, dispatch);
-    device.destroy(this->m_pool, alloc_cb, dispatch);
+    if (this->m_table->update) {
+      device.destroyDescriptorUpdateTemplate(this->m_table->update, alloc_cb,
+                                             dispatch);
+      this->m_table->update = nullptr;
+    }
+
+    auto destroy = [&](std::vector<vk::DescriptorPool>& pools) {
+      for (auto& pool : pools) {
+        device.resetDescriptorPool(pool, vk::DescriptorPoolResetFlags(),
+                                   dispatch);
+        device.destroy(pool, alloc_cb, dispatch);
+      }
+      pools.clear();
+    };
+
+    this->m_table->releases.clear();
+    destroy(this->m_chain.pools);
+    destroy(this->m_transient.pools);
+    for (auto& frame : this->m_frames) destroy(frame.pools);
+    this->m_frames.clear();
+    this->m_table->released = true;
     this->m_pipeline = nullptr;
   }
 }
 
 auto DescriptorPool::operator=(DescriptorPool&& mv) -> DescriptorPool& {
-  this->m_pool = mv.m_pool;
   this->m_amount = mv.m_amount;
   this->m_pipeline = mv.m_pipeline;
   this->m_layout = mv.m_layout;
   this->m_device = mv.m_device;
+  this->m_sizes = std::move(mv.m_sizes);
+  this->m_chain = std::move(mv.m_chain);
+  this->m_transient = std::move(mv.m_transient);
+  this->m_frames = std::move(mv.m_frames);
 
-  mv.m_pool = nullptr;
   mv.m_layout = nullptr;
   mv.m_device = nullptr;
   mv.m_pipeline = nullptr;
   mv.m_amount = 20;
+  mv.m_sizes.clear();
+  mv.m_chain = Chain();
+  mv.m_transient = Chain();
+  mv.m_frames.clear();
 
   this->m_map = std::move(mv.m_map);
+  this->m_table = std::move(mv.m_table);
   return *this;
 }
 
+/** Only sizes are worked out here. Pools are made as sets are first needed,
+ * so a pipeline nobody makes descriptors for never creates one.
+ */
 auto DescriptorPool::initialize(const Pipeline& pipeline, size_t amount)
     -> void {
-  const auto flag = vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet;
   const auto& shader = pipeline.shader();
 
   this->m_amount = amount;
@@ -78,175 +124,456 @@ auto DescriptorPool::initialize(const Pipeline& pipeline, size_t amount)
 
   auto& map = *this->m_map;
   const auto& stages = shader.file().stages();
+  const auto bindless = shader.device().heap() != nullptr;
   if (!stages.empty()) {
     for (auto& stage : stages) {
       for (auto& variable : stage.variables) {
+        if (bindless && variable.second.set == BINDLESS_SET) continue;
         map[variable.first] = variable.second;
       }
     }
 
     this->m_device = &shader.device();
     this->m_layout = shader.layout();
+    this->makeTable();
 
-    vk::DescriptorPoolCreateInfo info;
-    std::vector<vk::DescriptorPoolSize> sizes;
-    vk::DescriptorPoolSize size;
+    // Descriptors of each type one set needs, counting every array element.
+    auto& sizes = this->m_sizes;
+    for (const auto& uniform : map) {
+      auto type = convert(uniform.second.type);
+      auto count = std::max<uint32_t>(uniform.second.size, 1);
+      auto iter =
+          std::find_if(sizes.begin(), sizes.end(),
+                       [&type](auto& size) { return size.type == type; });
+      if (iter != sizes.end())
+        iter->descriptorCount += count;
+      else
+        sizes.push_back(vk::DescriptorPoolSize(type, count));
+    }
 
-    size.setDescriptorCount(this->m_amount);
-    sizes.reserve(map.size());
+    // Pipelines only using the heap still need a set to bind with.
+    if (sizes.empty() && bindless) {
+      auto type = vk::DescriptorType::eStorageBuffer;
+      sizes.push_back(vk::DescriptorPoolSize(type, 1));
+    }
 
-    for (const auto& uniform : map) {
-      size.setType(convert(uniform.second.type));
-      sizes.push_back(size);
+    if (!sizes.empty()) this->makeTemplate();
+  }
+}
+
+auto DescriptorPool::retire(vk::Fence fence) -> void {
+  this->reclaim();
+  if (this->m_transient.pools.empty()) return;
+
+  auto device = this->m_device->device();
+  auto& dispatch = this->m_device->dispatch();
+  auto frame = Frame();
+  frame.pools = std::move(this->m_transient.pools);
+  frame.fence = fence;
+  this->m_frames.push_back(std::move(frame));
+
+  // Frames finished by now give their pools back, reset in one call each
+  // instead of freeing every set. The next frame grows from the smallest
+  // size again, so one busy frame doesn't size every later one.
+  auto chain = Chain();
+  auto iter = this->m_frames.begin();
+  while (iter != this->m_frames.end()) {
+    if (device.getFenceStatus(iter->fence, dispatch) != vk::Result::eSuccess) {
+      ++iter;
+      continue;
+    }
+
+    for (auto& pool : iter->pools) {
+      device.resetDescriptorPool(pool, vk::DescriptorPoolResetFlags(),
+                                 dispatch);
+      chain.pools.push_back(pool);
+    }
+    iter = this->m_frames.erase(iter);
+  }
+  this->m_transient = std::move(chain);
+}
+
+/** Frees the sets of destroyed descriptors whose work is done by now, the same
+ * way finished frames are found.
+ */
+auto DescriptorPool::reclaim() -> void {
+  auto& releases = this->m_table->releases;
+  if (releases.empty()) return;
+
+  auto device = this->m_device->device();
+  auto& dispatch = this->m_device->dispatch();
+  auto done = [&device, &dispatch](const Release& release) {
+    for (auto& fence : release.fences) {
+      if (device.getFenceStatus(fence, dispatch) != vk::Result::eSuccess)
+        return false;
+    }
+    device.freeDescriptorSets(release.pool, release.set, dispatch);
+    return true;
+  };
+
+  releases.erase(std::remove_if(releases.begin(), releases.end(), done),
+                 releases.end());
+}
+
+auto DescriptorPool::binding(uint64_t hash) const -> int32_t {
+  return find(*this->m_table, hash);
+}
+
+/** IDs index a flat copy of the variables, found by the hash of their name so
+ * resolving one never builds a string.
+ */
+auto DescriptorPool::makeTable() -> void {
+  auto& table = *this->m_table;
+  for (auto& variable : *this->m_map) {
+    auto id = static_cast<int32_t>(table.bindings.size());
+    table.bindings.push_back(variable.second);
+    table.ids.push_back({bindingHash(variable.first), id});
+  }
+
+  table.slots.assign(1, 0);
+  for (auto& variable : table.bindings) {
+    table.slots.push_back(table.slots.back() + variable.size);
+  }
+
+  std::sort(table.ids.begin(), table.ids.end());
+  for (auto index = size_t(1); index < table.ids.size(); index++) {
+    OhmAssert(table.ids[index - 1].first == table.ids[index].first,
+              "Two shader variables' names hash to the same binding ID.");
+  }
+}
+
+/** Templates are core in Vulkan 1.1, so a device without one has no entry
+ * point and keeps updating with writes.
+ */
+auto DescriptorPool::makeTemplate() -> void {
+  auto& table = *this->m_table;
+  auto device = this->m_device->device();
+  auto& dispatch = this->m_device->dispatch();
+  auto* alloc_cb = this->m_device->allocationCB();
+  if (!dispatch.vkCreateDescriptorUpdateTemplate) return;
+
+  auto entries = std::vector<vk::DescriptorUpdateTemplateEntry>();
+  for (auto id = 0u; id < table.bindings.size(); id++) {
+    auto& variable = table.bindings[id];
+    auto count = table.slots[id + 1] - table.slots[id];
+
+    // A template can't write an unsized array.
+    if (count == 0) return;
+
+    auto entry = vk::DescriptorUpdateTemplateEntry();
+    entry.setDstBinding(variable.binding);
+    entry.setDstArrayElement(0);
+    entry.setDescriptorCount(static_cast<uint32_t>(count));
+    entry.setDescriptorType(convert(variable.type));
+    entry.setOffset(table.slots[id] * sizeof(Slot));
+    entry.setStride(sizeof(Slot));
+    entries.push_back(entry);
+  }
+
+  auto info = vk::DescriptorUpdateTemplateCreateInfo();
+  info.setDescriptorUpdateEntryCount(entries.size());
+  info.setPDescriptorUpdateEntries(entries.data());
+  info.setTemplateType(vk::DescriptorUpdateTemplateType::eDescriptorSet);
+  info.setDescriptorSetLayout(this->m_layout);
+  table.update =
+      error(device.createDescriptorUpdateTemplate(info, alloc_cb, dispatch));
+}
+
+auto DescriptorPool::makePool(Chain& chain, bool transient)
+    -> vk::DescriptorPool {
+  auto device = this->m_device->device();
+  auto& dispatch = this->m_device->dispatch();
+  auto* alloc_cb = this->m_device->allocationCB();
+  auto limit = std::max<size_t>(this->m_amount, 1);
+  chain.sets = chain.sets == 0 ? std::min<size_t>(MIN_DESCRIPTORS, limit)
+                               : std::min(chain.sets * 2, limit);
+
+  auto sizes = this->m_sizes;
+  for (auto& size : sizes) size.descriptorCount *= chain.sets;
+
+  // Transient sets are only ever reset together, so never need freeing.
+  auto info = vk::DescriptorPoolCreateInfo();
+  info.setPoolSizeCount(sizes.size());
+  info.setPPoolSizes(sizes.data());
+  info.setMaxSets(chain.sets);
+  if (!transient)
+    info.setFlags(vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet);
+
+  return error(device.createDescriptorPool(info, alloc_cb, dispatch));
+}
+
+/** Tries each pool of the chain, starting from the last one used, and only
+ * grows the chain once all of them are out of room.
+ */
+auto DescriptorPool::allocate(Chain& chain, bool transient)
+    -> std::pair<vk::DescriptorPool, vk::DescriptorSet> {
+  auto device = this->m_device->device();
+  auto& dispatch = this->m_device->dispatch();
+  auto set = vk::DescriptorSet();
+  auto info = vk::DescriptorSetAllocateInfo();
+  info.setDescriptorSetCount(1);
+  info.setPSetLayouts(&this->m_layout);
+
+  for (auto tried = size_t(0);; tried++) {
+    auto fresh = tried == chain.pools.size();
+    if (fresh) {
+      chain.current = chain.pools.size();
+      chain.pools.push_back(this->makePool(chain, transient));
     }
 
-    info.setPoolSizeCount(sizes.size());
-    info.setPPoolSizes(sizes.data());
-    info.setMaxSets(this->m_amount);
-    info.setFlags(flag);
-
-    if (info.poolSizeCount != 0) {
-      auto device = this->m_device->device();
-      auto& dispatch = this->m_device->dispatch();
-      auto* alloc_cb = this->m_device->allocationCB();
-      this->m_pool =
-          error(device.createDescriptorPool(info, alloc_cb, dispatch));
+    auto pool = chain.pools[chain.current];
+    info.setDescriptorPool(pool);
+    auto result = device.allocateDescriptorSets(&info, &set, dispatch);
+    if (result == vk::Result::eSuccess) return {pool, set};
+
+    // Out of room is only expected of pools already handed out sets.
+    if (fresh || (result != vk::Result::eErrorOutOfPoolMemory &&
+                  result != vk::Result::eErrorFragmentedPool)) {
+      OhmAssert(true, vk::to_string(result));
+      return {};
     }
+    chain.current = (chain.current + 1) % chain.pools.size();
   }
 }
 
 Descriptor::Descriptor() {
+  this->m_source = nullptr;
   this->m_device = nullptr;
   this->m_pipeline = nullptr;
+  this->m_unset = 0;
+  this->m_staged = 0;
 }
 
 Descriptor::Descriptor(Descriptor&& mv) { *this = std::move(mv); }
 
-Descriptor::Descriptor(DescriptorPool* pool) {
+Descriptor::Descriptor(DescriptorPool* pool, bool transient) {
+  this->m_source = nullptr;
   this->m_device = nullptr;
   this->m_pipeline = nullptr;
-  this->initialize(*pool);
+  this->m_unset = 0;
+  this->m_staged = 0;
+  this->initialize(*pool, transient);
 }
 
-Descriptor::~Descriptor() {}
+/** Sets still read by work in flight can't be freed yet, so they're handed to
+ * the pool with the fences of that work, and freed by it later.
+ */
+Descriptor::~Descriptor() {
+  if (this->m_source && !this->m_table->released) {
+    auto device = this->m_device->device();
+    auto& dispatch = this->m_device->dispatch();
+    auto release = DescriptorPool::Release{this->m_set, this->m_source, {}};
+    for (auto& fence : this->m_fences) {
+      if (device.getFenceStatus(fence, dispatch) != vk::Result::eSuccess)
+        release.fences.push_back(fence);
+    }
+
+    if (release.fences.empty())
+      device.freeDescriptorSets(this->m_source, this->m_set, dispatch);
+    else
+      this->m_table->releases.push_back(std::move(release));
+  }
+}
 
 auto Descriptor::operator=(Descriptor&& mv) -> Descriptor& {
   this->m_device = mv.m_device;
-  this->m_parent_map = std::move(mv.m_parent_map);
+  this->m_table = std::move(mv.m_table);
   this->m_pipeline = mv.m_pipeline;
+  this->m_slots = std::move(mv.m_slots);
+  this->m_states = std::move(mv.m_states);
+  this->m_unset = mv.m_unset;
+  this->m_staged = mv.m_staged;
   this->m_set = mv.m_set;
+  this->m_source = mv.m_source;
+  this->m_fences = std::move(mv.m_fences);
 
   mv.m_set = nullptr;
+  mv.m_source = nullptr;
   mv.m_device = nullptr;
   mv.m_pipeline = nullptr;
+  mv.m_unset = 0;
+  mv.m_staged = 0;
   return *this;
 }
 
-auto Descriptor::initialize(const DescriptorPool& pool) -> void {
-  const vk::DescriptorSetLayout layouts[] = {pool.m_layout};
-  vk::DescriptorSetAllocateInfo info;
+auto Descriptor::initialize(DescriptorPool& pool, bool transient) -> void {
+  if (pool.m_sizes.empty()) return;
+
+  if (!transient) pool.reclaim();
+  auto& chain = transient ? pool.m_transient : pool.m_chain;
+  auto allocation = pool.allocate(chain, transient);
+  if (!allocation.second) return;
+
+  auto count = pool.m_table->slots.back();
+  this->m_device = pool.m_device;
+  this->m_pipeline = pool.m_pipeline;
+  this->m_table = pool.m_table;
+  this->m_slots.assign(count, Slot());
+  this->m_states.assign(count, State::Unset);
+  this->m_unset = count;
+  this->m_staged = 0;
+  this->m_set = allocation.second;
+  this->m_source = transient ? vk::DescriptorPool() : allocation.first;
+  this->m_fences.clear();
+}
 
-  info.setDescriptorPool(pool.m_pool);
-  info.setPSetLayouts(layouts);
-  info.setDescriptorSetCount(1);
+auto Descriptor::bind(std::string_view name, const Buffer& buffer) -> void {
+  if (this->m_table) {
+    auto binding = find(*this->m_table, bindingHash(name));
+    if (binding >= 0) this->bind(binding, buffer);
+  }
+}
 
-  if (pool.m_pool) {
-    auto device = pool.m_device->device();
-    auto& dispatch = pool.m_device->dispatch();
-    auto result = error(device.allocateDescriptorSets(info, dispatch));
-    this->m_device = pool.m_device;
-    this->m_pipeline = pool.m_pipeline;
-    this->m_parent_map = pool.m_map;
-    this->m_set = result[0];
+auto Descriptor::bind(std::string_view name, const Image& image) -> void {
+  if (this->m_table) {
+    auto binding = find(*this->m_table, bindingHash(name));
+    if (binding >= 0) {
+      this->bind(binding, image);
+    } else {
+      OhmAssert(true, "Attempting to bind something that doesn't exist.");
+    }
   }
 }
 
-auto Descriptor::bind(std::string_view name, const Buffer& buffer) -> void {
-  if (this->m_parent_map) {
-    const auto iter = this->m_parent_map->find(std::string(name));
-    auto info = vk::DescriptorBufferInfo();
-    auto write = vk::WriteDescriptorSet();
+auto Descriptor::bind(std::string_view name, const Image** images,
+                      unsigned count) -> void {
+  if (this->m_table) {
+    auto binding = find(*this->m_table, bindingHash(name));
+    if (binding >= 0) {
+      this->bind(binding, images, count);
+    } else {
+      OhmAssert(true, "Attempting to bind something that doesn't exist.");
+    }
+  }
+}
 
-    if (iter != this->m_parent_map->end()) {
-      info.setBuffer(buffer.buffer());
-      info.setRange(VK_WHOLE_SIZE);
-      info.setOffset(0);
+auto Descriptor::bind(int32_t binding, const Buffer& buffer) -> void {
+  if (this->m_table) {
+    auto* slot = this->stage(binding, 0);
+    if (!slot) return;
 
-      write.setDstSet(this->m_set);
-      write.setDstBinding(iter->second.binding);
-      write.setDescriptorType(convert(iter->second.type));
-      write.setDstArrayElement(0);
-      write.setDescriptorCount(1);
-      write.setPBufferInfo(&info);
-
-      auto device = this->m_device->device();
-      auto& dispatch = this->m_device->dispatch();
-      device.updateDescriptorSets(1, &write, 0, nullptr, dispatch);
-    }
+    slot->buffer.buffer = buffer.buffer();
+    slot->buffer.offset = 0;
+    slot->buffer.range = VK_WHOLE_SIZE;
   }
 }
 
-auto Descriptor::bind(std::string_view name, const Image& image) -> void {
-  if (this->m_parent_map) {
-    const auto iter = this->m_parent_map->find(std::string(name));
-    vk::DescriptorImageInfo info;
-    vk::WriteDescriptorSet write;
+auto Descriptor::bind(int32_t binding, const Image& image) -> void {
+  if (this->m_table) {
+    auto* slot = this->stage(binding, image.layer());
+    if (!slot) return;
 
-    if (iter != this->m_parent_map->end()) {
-      info.setImageLayout(image.layout());
-      info.setSampler(image.sampler());
-      info.setImageView(image.view());
+    slot->image.sampler = image.sampler();
+    slot->image.imageView = image.view();
+    slot->image.imageLayout = static_cast<VkImageLayout>(image.layout());
+  }
+}
 
-      write.setDstSet(this->m_set);
-      write.setDstBinding(iter->second.binding);
-      write.setDescriptorType(convert(iter->second.type));
-      write.setDstArrayElement(image.layer());
-      write.setDescriptorCount(1);
-      write.setPImageInfo(&info);
-
-      auto device = this->m_device->device();
-      auto& dispatch = this->m_device->dispatch();
-      device.updateDescriptorSets(1, &write, 0, nullptr, dispatch);
-    } else {
-      OhmAssert(true, "Attempting to bind something that doesn't exist.");
+auto Descriptor::bind(int32_t binding, const Image** images, unsigned count)
+    -> void {
+  if (this->m_table) {
+    for (auto index = 0u; index < count; index++) {
+      auto* slot = this->stage(binding, index);
+      if (!slot) return;
+
+      slot->image.sampler = images[index]->sampler();
+      slot->image.imageView = images[index]->view();
+      slot->image.imageLayout =
+          static_cast<VkImageLayout>(images[index]->layout());
     }
   }
 }
 
-auto Descriptor::bind(std::string_view name, const Image** images,
-                      unsigned count) -> void {
-  if (this->m_parent_map) {
-    const auto iter = this->m_parent_map->find(std::string(name));
-    unsigned amt;
-    std::vector<vk::DescriptorImageInfo> infos;
-    vk::WriteDescriptorSet write;
-
-    if (iter != this->m_parent_map->end()) {
-      amt = count < iter->second.size ? count : iter->second.size;
-
-      infos.resize(count);
-      for (unsigned index = 0; index < count; index++) {
-        infos[index].setImageLayout(images[index]->layout());
-        infos[index].setSampler(images[index]->sampler());
-        infos[index].setImageView(images[index]->view());
-      }
+auto Descriptor::commit() -> void {
+  if (this->m_staged == 0) return;
+
+  auto device = this->m_device->device();
+  auto& dispatch = this->m_device->dispatch();
+  auto& update = this->m_table->update;
+  if (update && this->m_unset == 0) {
+    device.updateDescriptorSetWithTemplate(this->m_set, update,
+                                           this->m_slots.data(), dispatch);
+  } else {
+    auto writes = this->writes();
+    device.updateDescriptorSets(writes.size(), writes.data(), 0, nullptr,
+                                dispatch);
+  }
+
+  for (auto& state : this->m_states) {
+    if (state == State::Staged) state = State::Written;
+  }
+  this->m_staged = 0;
+}
+
+auto Descriptor::use(vk::Fence fence) -> void {
+  if (!this->m_source) return;
 
+  auto& fences = this->m_fences;
+  if (std::find(fences.begin(), fences.end(), fence) == fences.end())
+    fences.push_back(fence);
+}
+
+/** Returns the slot of one element of a binding, marking it staged, or null
+ * if the binding has no such element.
+ */
+auto Descriptor::stage(int32_t binding, size_t element) -> Slot* {
+  auto& table = *this->m_table;
+  OhmAssert(binding < 0 || binding >= int32_t(table.bindings.size()),
+            "Attempting to bind with an invalid binding ID.");
+
+  auto index = table.slots[binding] + element;
+  if (index >= table.slots[binding + 1]) return nullptr;
+
+  auto& state = this->m_states[index];
+  if (state == State::Unset) this->m_unset--;
+  if (state != State::Staged) this->m_staged++;
+  state = State::Staged;
+  return &this->m_slots[index];
+}
+
+/** Makes one write per run of staged elements, pointing into the slots.
+ */
+auto Descriptor::writes() -> std::vector<vk::WriteDescriptorSet> {
+  auto& table = *this->m_table;
+  auto writes = std::vector<vk::WriteDescriptorSet>();
+  writes.reserve(this->m_staged);
+
+  for (auto id = 0u; id < table.bindings.size(); id++) {
+    auto& variable = table.bindings[id];
+    auto type = convert(variable.type);
+    auto first = table.slots[id];
+    auto last = table.slots[id + 1];
+
+    for (auto index = first; index < last; index++) {
+      if (this->m_states[index] != State::Staged) continue;
+
+      auto end = index;
+      while (end < last && this->m_states[end] == State::Staged) end++;
+
+      auto* slot = &this->m_slots[index];
+      auto write = vk::WriteDescriptorSet();
       write.setDstSet(this->m_set);
-      write.setDstBinding(iter->second.binding);
-      write.setDescriptorType(convert(iter->second.type));
-      write.setDstArrayElement(0);
-      write.setDescriptorCount(amt);
-      write.setPImageInfo(infos.data());
-
-      auto device = this->m_device->device();
-      auto& dispatch = this->m_device->dispatch();
-      device.updateDescriptorSets(1, &write, 0, nullptr, dispatch);
-    } else {
-      OhmAssert(true, "Attempting to bind something that doesn't exist.");
+      write.setDstBinding(variable.binding);
+      write.setDescriptorType(type);
+      write.setDstArrayElement(static_cast<uint32_t>(index - first));
+      write.setDescriptorCount(static_cast<uint32_t>(end - index));
+      if (is_buffer(type))
+        write.setPBufferInfo(
+            reinterpret_cast<const vk::DescriptorBufferInfo*>(&slot->buffer));
+      else
+        write.setPImageInfo(
+            reinterpret_cast<const vk::DescriptorImageInfo*>(&slot->image));
+      writes.push_back(write);
+      index = end;
     }
   }
+  return writes;
 }
 
 auto DescriptorPool::make() -> Descriptor { return Descriptor(this); }
+
+auto DescriptorPool::makeTransient() -> Descriptor {
+  return Descriptor(this, true);
+}
 }  // namespace ovk
 }  // namespace ohm
@@ -1,7 +1,11 @@
 #pragma once
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 #include <vulkan/vulkan.hpp>
 #include "ohm/io/shader.h"
 #include "ohm/vulkan/impl/buffer.h"
@@ -9,6 +13,7 @@
 namespace ohm {
 namespace ovk {
 constexpr auto MAX_DESCRIPTORS = 4096;
+constexpr auto MIN_DESCRIPTORS = 16;
 class Pipeline;
 class DescriptorPool;
 class Descriptor;
@@ -21,44 +26,161 @@ class DescriptorPool {
   auto initialize(const Pipeline& shader, size_t amount = MAX_DESCRIPTORS)
       -> void;
   auto make() -> Descriptor;
+
+  /** Method to make a descriptor whose set is never freed on its own, only
+   * reset with every other transient set once retired.
+   */
+  auto makeTransient() -> Descriptor;
+
+  /** Method to hand every transient set made since the last retire to the
+   * fence of the work using them. Their pools are reset together once it's
+   * signaled, and reused by later transient descriptors.
+   */
+  auto retire(vk::Fence fence) -> void;
   auto update_reference(const Pipeline* ref) -> void { this->m_pipeline = ref; }
 
+  /** Method to resolve a variable's name hash, from ohm::bindingHash, into
+   * its index in the binding table.
+   * @return The binding ID, or -1 if no variable has that name.
+   */
+  auto binding(uint64_t hash) const -> int32_t;
+
  private:
   using UniformMap = std::unordered_map<std::string, io::ShaderVariable>;
+
+  /** Every descriptor's infos are packed as one slot per array element, in
+   * binding ID order, so the whole set can be written with one template.
+   */
+  union Slot {
+    VkDescriptorImageInfo image;
+    VkDescriptorBufferInfo buffer;
+  };
+
+  /** A set whose descriptor is gone while work using it may still run. It's
+   * freed once every one of its fences has signaled.
+   */
+  struct Release {
+    vk::DescriptorSet set;
+    vk::DescriptorPool pool;
+    std::vector<vk::Fence> fences;
+  };
+
+  /** What the pool's descriptors share, built once from reflection.
+   */
+  struct Table {
+    // Variables by binding ID.
+    std::vector<io::ShaderVariable> bindings;
+
+    // Name hash : binding ID, sorted by hash.
+    std::vector<std::pair<uint64_t, int32_t>> ids;
+
+    // The first slot of each binding ID, then the total slot count.
+    std::vector<size_t> slots;
+
+    // Writes every slot at once. Null if the device or layout can't use one.
+    vk::DescriptorUpdateTemplate update;
+
+    // Sets of destroyed descriptors, still waiting on their work.
+    std::vector<Release> releases;
+
+    // Set once the pool is destroyed, which frees every set along with it.
+    bool released = false;
+  };
+
+  /** Pools allocated from in turn. Each new one holds twice the sets of the
+   * last, up to the pool's amount, so pipelines only pay for what they use.
+   */
+  struct Chain {
+    std::vector<vk::DescriptorPool> pools;
+    size_t current = 0;
+    size_t sets = 0;
+  };
+
+  /** Transient pools waiting on the work that uses their sets.
+   */
+  struct Frame {
+    std::vector<vk::DescriptorPool> pools;
+    vk::Fence fence;
+  };
+
   friend class Descriptor;
   std::shared_ptr<UniformMap> m_map;
+  std::shared_ptr<Table> m_table;
   const Device* m_device;
   const Pipeline* m_pipeline;
   size_t m_device_id;
   size_t m_amount;
-  vk::DescriptorPool m_pool;
+  std::vector<vk::DescriptorPoolSize> m_sizes;
+  Chain m_chain;
+  Chain m_transient;
+  std::vector<Frame> m_frames;
   vk::DescriptorSetLayout m_layout;
+
+  inline auto makeTable() -> void;
+  inline auto makeTemplate() -> void;
+  inline auto reclaim() -> void;
+  inline auto makePool(Chain& chain, bool transient) -> vk::DescriptorPool;
+  inline auto allocate(Chain& chain, bool transient)
+      -> std::pair<vk::DescriptorPool, vk::DescriptorSet>;
 };
 
 class Descriptor {
  public:
   Descriptor();
   Descriptor(Descriptor&& desc);
-  Descriptor(DescriptorPool* pool);
+  Descriptor(DescriptorPool* pool, bool transient = false);
   ~Descriptor();
   auto operator=(Descriptor&& desc) -> Descriptor&;
-  auto initialize(const DescriptorPool& pool) -> void;
+  auto initialize(DescriptorPool& pool, bool transient = false) -> void;
   auto reset() -> void;
   auto bind(std::string_view name, const Image& image) -> void;
   auto bind(std::string_view name, const Image** images, unsigned count)
       -> void;
   auto bind(std::string_view name, const Buffer& buffer) -> void;
+  auto bind(int32_t binding, const Image& image) -> void;
+  auto bind(int32_t binding, const Image** images, unsigned count) -> void;
+  auto bind(int32_t binding, const Buffer& buffer) -> void;
+
+  /** Method to apply every staged bind in one update. Binds are only staged,
+   * so they take effect here or when the descriptor is next bound to
+   * commands.
+   */
+  auto commit() -> void;
+
+  /** Method to note that commands signaling the given fence recorded this
+   * set, so it's only freed once their work is done.
+   */
+  auto use(vk::Fence fence) -> void;
   auto initialized() const -> bool { return this->m_set; }
   auto pipeline() const -> const Pipeline& { return *this->m_pipeline; }
   auto set() -> vk::DescriptorSet& { return this->m_set; }
 
  private:
-  using UniformMap = DescriptorPool::UniformMap;
+  using Slot = DescriptorPool::Slot;
+  using Table = DescriptorPool::Table;
   friend class DescriptorPool;
+
+  // Per slot. Templates rewrite every slot, so they're only used once none
+  // are Unset.
+  enum class State : uint8_t { Unset, Written, Staged };
+
   vk::DescriptorSet m_set;
+
+  // The pool to free the set back to. Null for transient sets.
+  vk::DescriptorPool m_source;
+
+  // Fences of the commands that recorded the set.
+  std::vector<vk::Fence> m_fences;
   const Device* m_device;
-  std::shared_ptr<UniformMap> m_parent_map;
+  std::shared_ptr<Table> m_table;
   const Pipeline* m_pipeline;
+  std::vector<Slot> m_slots;
+  std::vector<State> m_states;
+  size_t m_unset;
+  size_t m_staged;
+
+  inline auto stage(int32_t binding, size_t element) -> Slot*;
+  inline auto writes() -> std::vector<vk::WriteDescriptorSet>;
 };
 }  // namespace ovk
 }  // namespace ohm
@@ -0,0 +1,147 @@
+#define VULKAN_HPP_ASSERT_ON_RESULT
+#define VULKAN_HPP_STORAGE_SHARED_EXPORT
+#define VULKAN_HPP_STORAGE_SHARED
+#define VULKAN_HPP_NO_DEFAULT_DISPATCHER
+#define VULKAN_HPP_NO_EXCEPTIONS
+
+#include "ohm/vulkan/impl/descriptor_heap.h"
+#include <array>
+#include <vulkan/vulkan.hpp>
+#include "ohm/vulkan/impl/buffer.h"
+#include "ohm/vulkan/impl/error.h"
+#include "ohm/vulkan/impl/image.h"
+
+namespace ohm {
+namespace ovk {
+constexpr auto heap_types = std::array<vk::DescriptorType, 3>{
+    vk::DescriptorType::eCombinedImageSampler,
+    vk::DescriptorType::eStorageImage,
+    vk::DescriptorType::eStorageBuffer,
+};
+
+DescriptorHeap::DescriptorHeap(vk::Device device,
+                               vk::AllocationCallbacks* alloc_cb,
+                               const vk::DispatchLoaderDynamic& dispatch,
+                               uint32_t size) {
+  const auto binding_flags =
+      vk::DescriptorBindingFlagBits::eUpdateAfterBind |
+      vk::DescriptorBindingFlagBits::eUpdateUnusedWhilePending |
+      vk::DescriptorBindingFlagBits::ePartiallyBound;
+
+  this->m_device = device;
+  this->m_alloc_cb = alloc_cb;
+  this->m_dispatch = dispatch;
+  this->m_size = size;
+  for (auto& written : this->m_written) written.assign(size, false);
+
+  auto bindings = std::array<vk::DescriptorSetLayoutBinding, 3>();
+  auto flags = std::array<vk::DescriptorBindingFlags, 3>();
+  auto sizes = std::array<vk::DescriptorPoolSize, 3>();
+  for (auto index = 0u; index < heap_types.size(); index++) {
+    bindings[index].setBinding(index);
+    bindings[index].setDescriptorType(heap_types[index]);
+    bindings[index].setDescriptorCount(size);
+    bindings[index].setStageFlags(vk::ShaderStageFlagBits::eAll);
+    flags[index] = binding_flags;
+    sizes[index].setType(heap_types[index]);
+    sizes[index].setDescriptorCount(size);
+  }
+
+  auto flags_info = vk::DescriptorSetLayoutBindingFlagsCreateInfo();
+  auto layout_info = vk::DescriptorSetLayoutCreateInfo();
+  flags_info.setBindingCount(flags.size());
+  flags_info.setPBindingFlags(flags.data());
+  layout_info.setBindingCount(bindings.size());
+  layout_info.setPBindings(bindings.data());
+  layout_info.setFlags(
+      vk::DescriptorSetLayoutCreateFlagBits::eUpdateAfterBindPool);
+  layout_info.setPNext(&flags_info);
+  this->m_layout = error(
+      device.createDescriptorSetLayout(layout_info, alloc_cb, dispatch));
+
+  auto pool_info = vk::DescriptorPoolCreateInfo();
+  pool_info.setPoolSizeCount(sizes.size());
+  pool_info.setPPoolSizes(sizes.data());
+  pool_info.setMaxSets(1);
+  pool_info.setFlags(vk::DescriptorPoolCreateFlagBits::eUpdateAfterBind);
+  this->m_pool =
+      error(device.createDescriptorPool(pool_info, alloc_cb, dispatch));
+
+  auto set_info = vk::DescriptorSetAllocateInfo();
+  set_info.setDescriptorPool(this->m_pool);
+  set_info.setDescriptorSetCount(1);
+  set_info.setPSetLayouts(&this->m_layout);
+  this->m_set = error(device.allocateDescriptorSets(set_info, dispatch))[0];
+}
+
+DescriptorHeap::~DescriptorHeap() {
+  this->m_device.destroy(this->m_pool, this->m_alloc_cb, this->m_dispatch);
+  this->m_device.destroy(this->m_layout, this->m_alloc_cb, this->m_dispatch);
+}
+
+auto DescriptorHeap::insert(uint32_t index, const Image& image) -> void {
+  if (index >= this->m_size) return;
+
+  auto info = vk::DescriptorImageInfo();
+  auto writes = std::array<vk::WriteDescriptorSet, 2>();
+  auto count = 0u;
+
+  info.setImageView(image.view());
+  info.setSampler(image.sampler());
+  info.setImageLayout(vk::ImageLayout::eGeneral);
+
+  auto write = vk::WriteDescriptorSet();
+  write.setDstSet(this->m_set);
+  write.setDstArrayElement(index);
+  write.setDescriptorCount(1);
+  write.setPImageInfo(&info);
+
+  if (image.sampler() && image.usage() & vk::ImageUsageFlagBits::eSampled) {
+    write.setDstBinding(Binding::Sampled);
+    write.setDescriptorType(heap_types[Binding::Sampled]);
+    writes[count++] = write;
+    this->m_written[Binding::Sampled][index] = true;
+  }
+
+  if (image.usage() & vk::ImageUsageFlagBits::eStorage) {
+    write.setDstBinding(Binding::Storage);
+    write.setDescriptorType(heap_types[Binding::Storage]);
+    writes[count++] = write;
+    this->m_written[Binding::Storage][index] = true;
+  }
+
+  if (count != 0) {
+    this->m_device.updateDescriptorSets(count, writes.data(), 0, nullptr,
+                                        this->m_dispatch);
+  }
+}
+
+auto DescriptorHeap::insert(uint32_t index, const Buffer& buffer) -> void {
+  if (index >= this->m_size) return;
+
+  auto info = vk::DescriptorBufferInfo();
+  auto write = vk::WriteDescriptorSet();
+
+  info.setBuffer(buffer.buffer());
+  info.setOffset(0);
+  info.setRange(VK_WHOLE_SIZE);
+
+  write.setDstSet(this->m_set);
+  write.setDstBinding(Binding::Arrays);
+  write.setDescriptorType(heap_types[Binding::Arrays]);
+  write.setDstArrayElement(index);
+  write.setDescriptorCount(1);
+  write.setPBufferInfo(&info);
+  this->m_device.updateDescriptorSets(1, &write, 0, nullptr, this->m_dispatch);
+  this->m_written[Binding::Arrays][index] = true;
+}
+
+auto DescriptorHeap::written(Binding binding, uint32_t index) const -> bool {
+  return index < this->m_size && this->m_written[binding][index];
+}
+
+auto DescriptorHeap::erase(Binding binding, uint32_t index) -> void {
+  if (index < this->m_size) this->m_written[binding][index] = false;
+}
+}  // namespace ovk
+}  // namespace ohm
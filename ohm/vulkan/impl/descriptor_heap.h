@@ -0,0 +1,69 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+namespace ohm {
+namespace ovk {
+class Buffer;
+class Image;
+
+/** The descriptor set pipelines see the heap at, after their own set.
+ */
+constexpr auto BINDLESS_SET = 1u;
+
+/** Object to manage a device's bindless descriptor heap: one update-after-bind
+ * set holding every image and array at the index of its handle, so shaders
+ * index resources directly and one bind covers all of them. In GLSL:
+ *
+ *   layout( set = 1, binding = 0 ) uniform sampler2D textures[] ;
+ *   layout( set = 1, binding = 1, rgba32f ) uniform image2D images[] ;
+ *   layout( set = 1, binding = 2 ) buffer Arrays { float data[]; } arrays[] ;
+ *
+ * Slots are partially bound, so ones never written, or whose object was
+ * destroyed, are fine as long as shaders don't access them.
+ * @note Only holds the device's raw handles, since Device objects move.
+ */
+class DescriptorHeap {
+ public:
+  enum Binding : uint32_t { Sampled = 0, Storage = 1, Arrays = 2 };
+
+  DescriptorHeap(vk::Device device, vk::AllocationCallbacks* alloc_cb,
+                 const vk::DispatchLoaderDynamic& dispatch, uint32_t size);
+  DescriptorHeap(const DescriptorHeap& cpy) = delete;
+  ~DescriptorHeap();
+  auto operator=(const DescriptorHeap& cpy) -> DescriptorHeap& = delete;
+
+  /** Method to write an image to its index, as a sampled image if it has a
+   * sampler and as a storage image if it allows storage. Heap images are read
+   * in the General layout, the one images rest in.
+   */
+  auto insert(uint32_t index, const Image& image) -> void;
+
+  auto insert(uint32_t index, const Buffer& buffer) -> void;
+
+  /** Method to check whether a slot of a binding has been written. Shaders
+   * must not read slots that haven't, or whose object has been destroyed.
+   */
+  auto written(Binding binding, uint32_t index) const -> bool;
+
+  /** Method to mark a slot empty again once its object is destroyed.
+   */
+  auto erase(Binding binding, uint32_t index) -> void;
+
+  auto layout() const -> vk::DescriptorSetLayout { return this->m_layout; }
+  auto set() const -> const vk::DescriptorSet& { return this->m_set; }
+  auto size() const -> uint32_t { return this->m_size; }
+
+ private:
+  vk::Device m_device;
+  vk::AllocationCallbacks* m_alloc_cb;
+  vk::DispatchLoaderDynamic m_dispatch;
+  vk::DescriptorSetLayout m_layout;
+  vk::DescriptorPool m_pool;
+  vk::DescriptorSet m_set;
+  std::array<std::vector<bool>, 3> m_written;
+  uint32_t m_size;
+};
+}  // namespace ovk
+}  // namespace ohm
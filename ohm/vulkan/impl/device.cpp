@@ -4,29 +4,45 @@
 #define VULKAN_HPP_NO_DEFAULT_DISPATCHER
 #define VULKAN_HPP_NO_EXCEPTIONS
 
+#include <algorithm>
 #include <memory>
 #include <utility>
 #include "ohm/vulkan/impl/device.h"
 #include "ohm/api/exception.h"
 #include "ohm/io/dlloader.h"
+#include "ohm/vulkan/impl/descriptor_heap.h"
 #include "ohm/vulkan/impl/error.h"
 #include "ohm/vulkan/impl/instance.h"
+#include "ohm/vulkan/impl/pipeline_cache.h"
 #include "ohm/vulkan/impl/system.h"
 
 namespace ohm {
 namespace ovk {
+// Descriptors per type left to a pipeline's own set, since it counts against
+// the same per-stage limits as the bindless heap.
+constexpr auto HEAP_RESERVE = 64u;
+
+// Heaps smaller than this aren't worth enabling bindless mode for.
+constexpr auto MIN_HEAP_SIZE = 64u;
 
 Device::Device() {
   this->extensions.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
   this->extensions.push_back(VK_KHR_SURFACE_EXTENSION_NAME);
+  this->extensions.push_back(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
   this->allocate_cb = nullptr;
   this->m_score = 0.0f;
+  this->m_bindless = false;
+  this->m_heap_size = 0;
 }
 
 Device::Device(Device&& mv) { *this = std::move(mv); }
 
 Device::~Device() {
+  this->m_heap.reset();
+  this->m_pipeline_cache.reset();
   if (this->gpu) {
+    for (auto& fence : this->m_fences)
+      this->gpu.destroy(fence, this->allocate_cb, this->m_dispatch);
     this->gpu.destroy(this->allocate_cb, ovk::system().instance.dispatch());
   }
 }
@@ -42,6 +58,11 @@ auto Device::operator=(Device&& mv) -> Device& {
   this->mem_heaps = mv.mem_heaps;
   this->features = mv.features;
   this->m_dispatch = mv.m_dispatch;
+  this->m_pipeline_cache = std::move(mv.m_pipeline_cache);
+  this->m_heap = std::move(mv.m_heap);
+  this->m_fences = std::move(mv.m_fences);
+  this->m_bindless = mv.m_bindless;
+  this->m_heap_size = mv.m_heap_size;
   this->queues = mv.queues;
   this->id = mv.id;
   this->extensions = mv.extensions;
@@ -58,7 +79,10 @@ auto Device::operator=(Device&& mv) -> Device& {
   mv.features = vk::PhysicalDeviceFeatures();
   mv.id = 0;
   mv.m_score = 0.f;
+  mv.m_bindless = false;
+  mv.m_heap_size = 0;
   mv.queue_props.clear();
+  mv.m_fences.clear();
   mv.extensions.clear();
   mv.validation.clear();
   for (auto& q : mv.queues) q = Queue();
@@ -119,16 +143,69 @@ auto Device::makeDevice() -> void {
 
   vk::PhysicalDeviceProperties2 props;
 
+  const auto supported =
+      this->physical_device.getFeatures(system().instance.dispatch());
+
   this->features.setShaderInt64(true);
   this->features.setFragmentStoresAndAtomics(true);
   this->features.setVertexPipelineStoresAndAtomics(true);
+  this->features.setPipelineStatisticsQuery(supported.pipelineStatisticsQuery);
+  this->features.setMultiDrawIndirect(supported.multiDrawIndirect);
+  this->features.setShaderSampledImageArrayDynamicIndexing(
+      supported.shaderSampledImageArrayDynamicIndexing);
+  this->features.setShaderStorageImageArrayDynamicIndexing(
+      supported.shaderStorageImageArrayDynamicIndexing);
+  this->features.setShaderStorageBufferArrayDynamicIndexing(
+      supported.shaderStorageBufferArrayDynamicIndexing);
   info.setQueueCreateInfos(queue_infos);
   info.setEnabledExtensionCount(extensions.size());
   info.setPpEnabledExtensionNames(extensions.data());
   info.setEnabledLayerCount(validation.size());
   info.setPpEnabledLayerNames(validation.data());
   info.setPEnabledFeatures(&this->features);
-  //      info.setPNext                  ( &this->pnext_chain ) ;
+
+  // Bindless heaps need their slots to be partially bound and updatable while
+  // in use, so only enable the mode when all of that is supported.
+  auto indexing = vk::PhysicalDeviceDescriptorIndexingFeatures();
+  if (this->supports(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME)) {
+    auto query = vk::PhysicalDeviceFeatures2();
+    query.setPNext(&indexing);
+    this->physical_device.getFeatures2(&query, system().instance.dispatch());
+    indexing.setPNext(nullptr);
+
+    // The heap is sized to fit the device's update-after-bind limits, with
+    // each of its bindings counting against the per-stage resource limit.
+    auto limits = vk::PhysicalDeviceDescriptorIndexingProperties();
+    auto properties = vk::PhysicalDeviceProperties2();
+    properties.setPNext(&limits);
+    this->physical_device.getProperties2(&properties,
+                                         system().instance.dispatch());
+    auto fit = [](uint32_t limit) {
+      return limit > HEAP_RESERVE ? limit - HEAP_RESERVE : 0u;
+    };
+    this->m_heap_size = std::min<uint32_t>({
+        static_cast<uint32_t>(CACHE_SIZE),
+        fit(limits.maxDescriptorSetUpdateAfterBindSamplers),
+        fit(limits.maxDescriptorSetUpdateAfterBindSampledImages),
+        fit(limits.maxDescriptorSetUpdateAfterBindStorageImages),
+        fit(limits.maxDescriptorSetUpdateAfterBindStorageBuffers),
+        fit(limits.maxPerStageDescriptorUpdateAfterBindSamplers),
+        fit(limits.maxPerStageDescriptorUpdateAfterBindSampledImages),
+        fit(limits.maxPerStageDescriptorUpdateAfterBindStorageImages),
+        fit(limits.maxPerStageDescriptorUpdateAfterBindStorageBuffers),
+        fit(limits.maxPerStageUpdateAfterBindResources) / 3,
+    });
+
+    this->m_bindless =
+        indexing.runtimeDescriptorArray &&
+        indexing.descriptorBindingPartiallyBound &&
+        indexing.descriptorBindingUpdateUnusedWhilePending &&
+        indexing.descriptorBindingSampledImageUpdateAfterBind &&
+        indexing.descriptorBindingStorageImageUpdateAfterBind &&
+        indexing.descriptorBindingStorageBufferUpdateAfterBind &&
+        this->m_heap_size >= MIN_HEAP_SIZE;
+    if (this->m_bindless) info.setPNext(&indexing);
+  }
   error(this->physical_device.createDevice(&info, this->allocate_cb, &this->gpu,
                                            system().instance.dispatch()));
 }
@@ -213,6 +290,14 @@ auto Device::initialize(io::Dlloader& loader, vk::AllocationCallbacks* callback,
                             loader.symbol("vkGetInstanceProcAddr")),
                         this->gpu);
 
+  // The cache copies the dispatcher, so it's only made once that's loaded.
+  this->m_pipeline_cache = std::make_unique<PipelineCache>(
+      this->gpu, this->allocate_cb, this->m_dispatch, this->properties);
+  if (this->m_bindless) {
+    this->m_heap = std::make_unique<DescriptorHeap>(
+        this->gpu, this->allocate_cb, this->m_dispatch, this->m_heap_size);
+  }
+
   /* Check and see if we found Queues. If not, set to the 'last available queue'
    * as to not break if people need to use say, a compute queue even though
    * teeeeeechnically their device doesn't support it.
@@ -256,6 +341,7 @@ auto Device::initialize(vk::Device import, io::Dlloader& loader,
                         vk::PhysicalDevice device) -> void {
   this->physical_device = device;
   this->allocate_cb = callback;
+  this->properties = device.getProperties(system().instance.dispatch());
 
   this->findQueueFamilies();
   this->gpu = import;
@@ -263,6 +349,8 @@ auto Device::initialize(vk::Device import, io::Dlloader& loader,
                         reinterpret_cast<PFN_vkGetInstanceProcAddr>(
                             loader.symbol("vkGetInstanceProcAddr")),
                         this->gpu);
+  this->m_pipeline_cache = std::make_unique<PipelineCache>(
+      this->gpu, this->allocate_cb, this->m_dispatch, this->properties);
   this->queues[GRAPHICS].queue =
       this->gpu.getQueue(this->queues[GRAPHICS].id, 0, this->m_dispatch);
   this->queues[COMPUTE].queue =
@@ -291,6 +379,13 @@ auto Device::addValidation(const char* validation) -> void {
   this->validation.push_back(validation);
 }
 
+auto Device::supports(std::string_view extension) const -> bool {
+  for (const auto& enabled : this->extensions) {
+    if (enabled == extension) return true;
+  }
+  return false;
+}
+
 auto Device::score() -> float { return this->m_score; }
 
 auto Device::checkSupport(vk::SurfaceKHR surface) const -> void {
@@ -298,6 +393,25 @@ auto Device::checkSupport(vk::SurfaceKHR surface) const -> void {
                                               surface, this->dispatch()));
 }
 
+auto Device::fence() -> vk::Fence {
+  auto lock = std::unique_lock<std::mutex>(this->m_fence_lock);
+  if (!this->m_fences.empty()) {
+    auto fence = this->m_fences.back();
+    this->m_fences.pop_back();
+    return fence;
+  }
+
+  auto info = vk::FenceCreateInfo();
+  info.setFlags(vk::FenceCreateFlagBits::eSignaled);
+  return error(
+      this->gpu.createFence(info, this->allocate_cb, this->m_dispatch));
+}
+
+auto Device::recycle(vk::Fence fence) -> void {
+  auto lock = std::unique_lock<std::mutex>(this->m_fence_lock);
+  this->m_fences.push_back(fence);
+}
+
 auto Device::memoryProperties() -> vk::PhysicalDeviceMemoryProperties& {
   return this->mem_prop;
 }
@@ -2,6 +2,7 @@
 
 #include <array>
 #include <climits>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <vector>
@@ -15,6 +16,8 @@ class Dlloader;
 
 namespace ovk {
 class Instance;
+class PipelineCache;
+class DescriptorHeap;
 
 struct Queue {
   vk::Queue queue;
@@ -56,6 +59,7 @@ class Device {
   auto name() -> std::string {return std::string(&this->properties.deviceName[0]);};
   auto addExtension(const char* extension) -> void;
   auto addValidation(const char* validation) -> void;
+  auto supports(std::string_view extension) const -> bool;
   auto score() -> float;
   auto checkSupport(vk::SurfaceKHR surface) const -> void;
   inline auto device() const -> vk::Device { return this->gpu; }
@@ -66,12 +70,42 @@ class Device {
   inline auto compute() -> Queue& { return this->queues[COMPUTE]; }
   inline auto transfer() -> Queue& { return this->queues[TRANSFER]; }
   inline auto sparse() -> Queue& { return this->queues[SPARSE]; }
+  inline auto limits() const -> const vk::PhysicalDeviceLimits& {
+    return this->properties.limits;
+  }
+  inline auto enabledFeatures() const -> const vk::PhysicalDeviceFeatures& {
+    return this->features;
+  }
+  inline auto families() const
+      -> const std::vector<vk::QueueFamilyProperties>& {
+    return this->queue_props;
+  }
   inline auto allocationCB() const -> vk::AllocationCallbacks* {
     return this->allocate_cb;
   }
   inline auto dispatch() const -> const vk::DispatchLoaderDynamic& {
     return this->m_dispatch;
   }
+  inline auto pipelineCache() -> PipelineCache& {
+    return *this->m_pipeline_cache;
+  }
+
+  /** Method to retrieve the device's bindless descriptor heap.
+   * @return The heap, or null unless bindless mode was enabled before
+   * initialization and the device supports descriptor indexing.
+   */
+  inline auto heap() const -> DescriptorHeap* { return this->m_heap.get(); }
+
+  /** Method to get a signaled fence, reusing one given back by destroyed
+   * commands when there is one.
+   */
+  auto fence() -> vk::Fence;
+
+  /** Method to give back a signaled fence nothing will submit with anymore.
+   * Fences live as long as the device, so work still tracking one, like a
+   * pipeline's retired descriptor sets, never queries a destroyed one.
+   */
+  auto recycle(vk::Fence fence) -> void;
   auto memoryProperties() -> vk::PhysicalDeviceMemoryProperties&;
   auto heaps() const -> const std::vector<GpuMemoryHeap>&;
 
@@ -86,11 +120,17 @@ class Device {
   vk::PhysicalDeviceFeatures features;
   vk::PhysicalDeviceMemoryProperties mem_prop;
   vk::DispatchLoaderDynamic m_dispatch;
+  std::unique_ptr<PipelineCache> m_pipeline_cache;
+  std::unique_ptr<DescriptorHeap> m_heap;
+  std::vector<vk::Fence> m_fences;
+  std::mutex m_fence_lock;
   std::array<Queue, 4> queues;
   unsigned id;
   std::vector<std::string> extensions;
   std::vector<std::string> validation;
   float m_score;
+  bool m_bindless;
+  uint32_t m_heap_size;
 
   inline auto findQueueFamilies() -> void;
 
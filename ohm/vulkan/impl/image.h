@@ -39,6 +39,7 @@ class Image {
   inline auto offset() const { return this->m_memory->offset; }
   inline auto view() const { return this->m_view; }
   inline auto sampler() const { return this->m_sampler; }
+  inline auto usage() const { return this->m_usage_flags; }
   inline auto image() const { return this->m_image; }
   inline auto count() const { return this->m_info.count(); }
   inline auto width() const { return this->m_info.width; }
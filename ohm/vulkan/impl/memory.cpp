@@ -39,6 +39,7 @@ Memory::Memory() {
   this->host_ptr = nullptr;
   this->device = nullptr;
   this->memory = nullptr;
+  this->owner = false;
 }
 
 Memory::Memory(Device& device, unsigned size, size_t heap, HeapType type) {
@@ -59,6 +60,7 @@ Memory::Memory(Device& device, unsigned size, size_t heap, HeapType type) {
   this->coherent = type & HeapType::HostVisible;
   this->size = size;
   this->offset = 0;
+  this->owner = true;
 }
 
 Memory::Memory(const Memory& parent, unsigned offset) {
@@ -71,12 +73,15 @@ Memory::Memory(const Memory& parent, unsigned offset) {
   this->type = parent.type;
 
   this->offset = offset + parent.offset;
+
+  // Offsets share the parent's allocation, which stays the parent's to free.
+  this->owner = false;
 }
 
 Memory::Memory(Memory&& mv) { *this = std::move(mv); }
 
 Memory::~Memory() {
-  if (this->initialized() && this->offset == 0) {
+  if (this->initialized() && this->owner) {
     this->device->device().free(this->memory, this->device->allocationCB(),
                                 this->device->dispatch());
     this->size = 0;
@@ -86,6 +91,7 @@ Memory::~Memory() {
     this->memory = nullptr;
     this->device = nullptr;
     this->heap = 0;
+    this->owner = false;
   }
 }
 
@@ -98,6 +104,7 @@ auto Memory::operator=(Memory&& mv) -> Memory& {
   this->device = mv.device;
   this->heap = mv.heap;
   this->type = mv.type;
+  this->owner = mv.owner;
 
   mv.size = 0;
   mv.offset = 0;
@@ -106,6 +113,7 @@ auto Memory::operator=(Memory&& mv) -> Memory& {
   mv.memory = nullptr;
   mv.device = nullptr;
   mv.heap = 0;
+  mv.owner = false;
   return *this;
 }
 
@@ -58,6 +58,7 @@ struct Memory {
   vk::DeviceMemory memory;
   Device* device;
   HeapType type;
+  bool owner;
 };
 }  // namespace ovk
 }  // namespace ohm
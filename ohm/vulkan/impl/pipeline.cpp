@@ -7,10 +7,13 @@
 #include "ohm/vulkan/impl/pipeline.h"
 #include <cstdio>
 #include <utility>
+#include <vector>
 #include <vulkan/vulkan.hpp>
 #include "ohm/api/pipeline.h"
+#include "ohm/vulkan/impl/descriptor_heap.h"
 #include "ohm/vulkan/impl/device.h"
 #include "ohm/vulkan/impl/error.h"
+#include "ohm/vulkan/impl/pipeline_cache.h"
 #include "ohm/vulkan/impl/render_pass.h"
 #include "ohm/vulkan/impl/shader.h"
 
@@ -27,6 +30,17 @@ static auto convert(Topology topology) -> vk::PrimitiveTopology {
   }
 }
 
+/** Only inline GLSL is compiled; every other source is already SPIR-V.
+ */
+static auto make_shader(Device& device, const PipelineInfo& info)
+    -> std::unique_ptr<Shader> {
+  if (info.shader) return std::make_unique<Shader>(device, info.shader);
+  if (!info.spirv.empty()) return std::make_unique<Shader>(device, info.spirv);
+  if (!info.inline_files.empty())
+    return std::make_unique<Shader>(device, info.inline_files);
+  return std::make_unique<Shader>(device, info.file_name);
+}
+
 Pipeline::Pipeline() {}
 
 Pipeline::~Pipeline() {
@@ -43,10 +57,7 @@ Pipeline::~Pipeline() {
 Pipeline::Pipeline(Device& device, const PipelineInfo& info) {
   this->m_device = &device;
 
-  if (info.inline_files.empty())
-    this->m_shader = std::make_unique<Shader>(device, info.file_name);
-  else
-    this->m_shader = std::make_unique<Shader>(device, info.inline_files);
+  this->m_shader = make_shader(device, info);
 
   this->m_pool.initialize(*this);
   this->init_params();
@@ -60,10 +71,7 @@ Pipeline::Pipeline(RenderPass& pass, const PipelineInfo& info)
   this->init_params();
   this->m_device      = pass.device() ;
   this->m_render_pass = &pass          ;
-  if(info.inline_files.empty())
-   this->m_shader = std::make_unique<Shader>(*this->m_device, info.file_name);
-  else
-    this->m_shader = std::make_unique<Shader>(*this->m_device, info.inline_files);
+  this->m_shader = make_shader(*this->m_device, info);
 
   this->m_pool.initialize( *this ) ;
 
@@ -94,6 +102,7 @@ auto Pipeline::operator=(Pipeline&& mv) -> Pipeline& {
   this->m_depth_stencil_info = mv.m_depth_stencil_info;
   this->m_sample_mask = mv.m_sample_mask;
   this->m_color_blend_attachments = mv.m_color_blend_attachments;
+  this->m_specialization = mv.m_specialization;
 
   mv.m_render_pass = nullptr;
   mv.m_device = nullptr;
@@ -108,10 +117,8 @@ auto Pipeline::operator=(Pipeline&& mv) -> Pipeline& {
 
 auto Pipeline::init_params() -> void {
   this->m_render_pass = nullptr;
-  this->m_push_constant_size = 128;
-  this->m_push_constant_flags = vk::ShaderStageFlagBits::eVertex |
-                                vk::ShaderStageFlagBits::eFragment |
-                                vk::ShaderStageFlagBits::eCompute;
+  this->m_push_constant_size = 0;
+  this->m_push_constant_flags = {};
 
   vk::ColorComponentFlags color_blend_mask;
 
@@ -165,9 +172,12 @@ auto Pipeline::init_params() -> void {
 auto Pipeline::createLayout() -> void {
   auto info = vk::PipelineLayoutCreateInfo();
   auto range = vk::PushConstantRange();
-  auto desc_layout = vk::DescriptorSetLayout();
+  auto desc_layouts = std::vector<vk::DescriptorSetLayout>();
 
-  desc_layout = this->m_shader->layout();
+  // Bindless devices put their heap after the pipeline's own set.
+  desc_layouts.push_back(this->m_shader->layout());
+  if (this->m_device->heap())
+    desc_layouts.push_back(this->m_device->heap()->layout());
 
   auto tmp = this->m_color_blend_attachments[0];
   //      this->m_color_blend_attachments.resize(
@@ -179,13 +189,18 @@ auto Pipeline::createLayout() -> void {
 
   this->m_color_blend_info.setAttachments(this->m_color_blend_attachments);
 
+  // The push constant range is sized off of what the shader's stages actually
+  // declare, so pipelines without a push constant block don't reserve one.
+  this->m_push_constant_size = this->m_shader->pushConstantSize();
+  this->m_push_constant_flags = this->m_shader->pushConstantFlags();
+
   range.setOffset(0);
   range.setSize(this->m_push_constant_size);
   range.setStageFlags(this->m_push_constant_flags);
 
-  info.setSetLayoutCount(1);
-  info.setPSetLayouts(&desc_layout);
-  info.setPushConstantRangeCount(1);
+  info.setSetLayoutCount(desc_layouts.size());
+  info.setPSetLayouts(desc_layouts.data());
+  info.setPushConstantRangeCount(this->m_push_constant_size != 0 ? 1 : 0);
   info.setPPushConstantRanges(&range);
 
   this->m_layout = error(this->m_device->device().createPipelineLayout(
@@ -196,18 +211,22 @@ auto Pipeline::createPipeline() -> void {
   auto graphics_info = vk::GraphicsPipelineCreateInfo();
   auto compute_info = vk::ComputePipelineCreateInfo();
   auto vertex_input = vk::PipelineVertexInputStateCreateInfo();
+  auto specialization = Shader::Specialization();
+  auto stages =
+      this->m_shader->shaderInfos(this->m_specialization, specialization);
 
   auto device = this->m_device->device();
   auto* alloc_cb = this->m_device->allocationCB();
   auto& dispatch = this->m_device->dispatch();
 
+  this->m_cache = this->m_device->pipelineCache().local();
   if (this->graphics()) {
     vertex_input.setVertexAttributeDescriptions(this->m_shader->inputs());
     vertex_input.setVertexBindingDescriptions(this->m_shader->bindings());
     this->m_viewport_info.setViewports(this->m_viewports);
     this->m_viewport_info.setScissors(this->m_scissors);
 
-    graphics_info.setStages(this->m_shader->shaderInfos());
+    graphics_info.setStages(stages);
     graphics_info.setLayout(this->m_layout);
     graphics_info.setPVertexInputState(&vertex_input);
     graphics_info.setPInputAssemblyState(&this->m_assembly_info);
@@ -222,7 +241,7 @@ auto Pipeline::createPipeline() -> void {
         this->m_cache, graphics_info, alloc_cb, dispatch));
   } else {
     compute_info.setLayout(this->m_layout);
-    compute_info.setStage(this->m_shader->shaderInfos()[0]);
+    compute_info.setStage(stages[0]);
 
     this->m_pipeline = error(device.createComputePipeline(
         this->m_cache, compute_info, alloc_cb, dispatch));
@@ -259,6 +278,7 @@ auto Pipeline::parse(const PipelineInfo& info) -> void {
   }
 
   this->m_assembly_info.setTopology(convert(info.topology));
+  this->m_specialization = info.specialization;
 
   for (auto& viewport : info.viewports) {
     this->addViewport(viewport);
@@ -267,5 +287,9 @@ auto Pipeline::parse(const PipelineInfo& info) -> void {
 }
 
 auto Pipeline::descriptor() -> Descriptor { return this->m_pool.make(); }
+
+auto Pipeline::transientDescriptor() -> Descriptor {
+  return this->m_pool.makeTransient();
+}
 }  // namespace ovk
 }  // namespace ohm
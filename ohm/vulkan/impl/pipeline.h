@@ -1,4 +1,5 @@
 #pragma once
+#include <map>
 #include <memory>
 #include <vector>
 #include "ohm/api/pipeline.h"
@@ -20,6 +21,8 @@ class Pipeline {
   ~Pipeline();
   auto operator=(Pipeline&& mv) -> Pipeline&;
   auto descriptor() -> Descriptor;
+  auto transientDescriptor() -> Descriptor;
+  auto retire(vk::Fence fence) -> void { this->m_pool.retire(fence); }
 
   auto initialized() const -> bool { return this->m_pipeline; }
   auto device() const -> const Device& { return *this->m_device; }
@@ -27,6 +30,15 @@ class Pipeline {
   auto shader() const -> const Shader& { return *this->m_shader; }
   auto pipeline() const -> vk::Pipeline { return this->m_pipeline; }
   auto layout() const -> vk::PipelineLayout { return this->m_layout; }
+  auto binding(uint64_t hash) const -> int32_t {
+    return this->m_pool.binding(hash);
+  }
+  auto pushConstantSize() const -> unsigned {
+    return this->m_push_constant_size;
+  }
+  auto pushConstantFlags() const -> vk::ShaderStageFlags {
+    return this->m_push_constant_flags;
+  }
 
  private:
   using Viewports = std::vector<vk::Viewport>;
@@ -38,6 +50,7 @@ class Pipeline {
   DescriptorPool m_pool;
   Device* m_device;
   std::unique_ptr<ovk::Shader> m_shader;
+  std::map<uint32_t, uint64_t> m_specialization;
   vk::Pipeline m_pipeline;
   vk::PipelineLayout m_layout;
   vk::PipelineCache m_cache;
@@ -0,0 +1,149 @@
+#define VULKAN_HPP_ASSERT_ON_RESULT
+#define VULKAN_HPP_STORAGE_SHARED_EXPORT
+#define VULKAN_HPP_STORAGE_SHARED
+#define VULKAN_HPP_NO_DEFAULT_DISPATCHER
+#define VULKAN_HPP_NO_EXCEPTIONS
+
+#include "ohm/vulkan/impl/pipeline_cache.h"
+#include <cstring>
+#include <fstream>
+#include <vulkan/vulkan.hpp>
+#include "ohm/io/serialize.h"
+#include "ohm/vulkan/impl/error.h"
+
+namespace ohm {
+namespace ovk {
+constexpr uint32_t CACHE_MAGIC = 0x4350484f;  // "OHPC"
+constexpr uint32_t CACHE_VERSION = 1;
+
+/** Written in front of the driver's data, so a file from another device,
+ * driver or build of ohm is never handed to the driver.
+ */
+struct CacheHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t vendor;
+  uint32_t device;
+  uint32_t driver;
+  uint8_t uuid[VK_UUID_SIZE];
+  uint64_t size;
+};
+
+PipelineCache::PipelineCache(vk::Device device,
+                             vk::AllocationCallbacks* alloc_cb,
+                             const vk::DispatchLoaderDynamic& dispatch,
+                             const vk::PhysicalDeviceProperties& properties) {
+  this->m_device = device;
+  this->m_alloc_cb = alloc_cb;
+  this->m_dispatch = dispatch;
+  this->m_properties = properties;
+}
+
+PipelineCache::~PipelineCache() {
+  for (auto& cache : this->m_caches) {
+    this->m_device.destroy(cache.second, this->m_alloc_cb, this->m_dispatch);
+  }
+  this->m_caches.clear();
+}
+
+auto PipelineCache::load(std::string_view directory) -> bool {
+  auto stream = std::ifstream(this->path(directory), std::ios::binary);
+  auto header = CacheHeader();
+
+  if (!stream) return false;
+  if (!stream.read(reinterpret_cast<char*>(&header), sizeof(header)))
+    return false;
+
+  auto& props = this->m_properties;
+  auto valid = header.magic == CACHE_MAGIC &&
+               header.version == CACHE_VERSION &&
+               header.vendor == props.vendorID &&
+               header.device == props.deviceID &&
+               header.driver == props.driverVersion &&
+               std::memcmp(header.uuid, &props.pipelineCacheUUID[0],
+                           VK_UUID_SIZE) == 0;
+  if (!valid) return false;
+
+  auto seed = std::vector<char>(header.size);
+  if (!stream.read(seed.data(), seed.size())) return false;
+
+  auto lock = std::unique_lock<std::mutex>(this->m_lock);
+  this->m_seed = std::move(seed);
+  return true;
+}
+
+auto PipelineCache::save(std::string_view directory) -> bool {
+  auto info = vk::PipelineCacheCreateInfo();
+  auto sources = std::vector<vk::PipelineCache>();
+  auto data = std::vector<char>();
+
+  {
+    auto lock = std::unique_lock<std::mutex>(this->m_lock);
+    for (auto& cache : this->m_caches) sources.push_back(cache.second);
+
+    info.setInitialDataSize(this->m_seed.size());
+    info.setPInitialData(this->m_seed.data());
+  }
+
+  // Merge into a scratch cache so no thread's cache is held while saving.
+  auto merged = error(this->m_device.createPipelineCache(info, this->m_alloc_cb,
+                                                         this->m_dispatch));
+  if (!sources.empty()) {
+    error(this->m_device.mergePipelineCaches(
+        merged, static_cast<uint32_t>(sources.size()), sources.data(),
+        this->m_dispatch));
+  }
+
+  auto size = size_t(0);
+  auto result = this->m_device.getPipelineCacheData(merged, &size, nullptr,
+                                                    this->m_dispatch);
+  if (result == vk::Result::eSuccess) {
+    data.resize(size);
+    result = this->m_device.getPipelineCacheData(merged, &size, data.data(),
+                                                 this->m_dispatch);
+    data.resize(size);
+  }
+  this->m_device.destroy(merged, this->m_alloc_cb, this->m_dispatch);
+  if (result != vk::Result::eSuccess) return false;
+
+  auto header = CacheHeader();
+  auto& props = this->m_properties;
+  header.magic = CACHE_MAGIC;
+  header.version = CACHE_VERSION;
+  header.vendor = props.vendorID;
+  header.device = props.deviceID;
+  header.driver = props.driverVersion;
+  header.size = data.size();
+  std::memcpy(header.uuid, &props.pipelineCacheUUID[0], VK_UUID_SIZE);
+
+  auto out = io::Writer();
+  out.value(header);
+  out.raw(data.data(), data.size());
+  return io::write_file(this->path(directory), out.bytes);
+}
+
+auto PipelineCache::local() -> vk::PipelineCache {
+  auto lock = std::unique_lock<std::mutex>(this->m_lock);
+  auto id = std::this_thread::get_id();
+  auto iter = this->m_caches.find(id);
+  if (iter != this->m_caches.end()) return iter->second;
+
+  auto info = vk::PipelineCacheCreateInfo();
+  info.setInitialDataSize(this->m_seed.size());
+  info.setPInitialData(this->m_seed.data());
+
+  auto cache = error(this->m_device.createPipelineCache(info, this->m_alloc_cb,
+                                                        this->m_dispatch));
+  this->m_caches[id] = cache;
+  return cache;
+}
+
+auto PipelineCache::path(std::string_view directory) const -> std::string {
+  auto name = std::string(directory);
+  if (!name.empty() && name.back() != '/') name += '/';
+  name += "ohm_pipeline_cache_" + std::to_string(this->m_properties.vendorID) +
+          "_" + std::to_string(this->m_properties.deviceID) + ".bin";
+  return name;
+}
+}  // namespace ovk
+}  // namespace ohm
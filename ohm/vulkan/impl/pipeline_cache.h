@@ -0,0 +1,54 @@
+#pragma once
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+namespace ohm {
+namespace ovk {
+/** Object to manage a device's pipeline caches. Every thread creating
+ * pipelines gets its own vk::PipelineCache so they never contend, and all of
+ * them are merged when saving. The file on disk is only used when it was
+ * written by the same device and driver.
+ * @note Only holds the device's raw handles, since Device objects move.
+ */
+class PipelineCache {
+ public:
+  PipelineCache(vk::Device device, vk::AllocationCallbacks* alloc_cb,
+                const vk::DispatchLoaderDynamic& dispatch,
+                const vk::PhysicalDeviceProperties& properties);
+  PipelineCache(const PipelineCache& cpy) = delete;
+  ~PipelineCache();
+  auto operator=(const PipelineCache& cpy) -> PipelineCache& = delete;
+
+  /** Method to seed every cache created afterwards from this device's file in
+   * a directory.
+   * @return Whether the file existed and matched this device and driver.
+   */
+  auto load(std::string_view directory) -> bool;
+
+  /** Method to merge every thread's cache and write them to this device's
+   * file in a directory.
+   * @return Whether the file was written.
+   */
+  auto save(std::string_view directory) -> bool;
+
+  /** Method to retrieve the calling thread's cache, creating it if needed.
+   */
+  auto local() -> vk::PipelineCache;
+
+ private:
+  auto path(std::string_view directory) const -> std::string;
+
+  vk::Device m_device;
+  vk::AllocationCallbacks* m_alloc_cb;
+  vk::DispatchLoaderDynamic m_dispatch;
+  vk::PhysicalDeviceProperties m_properties;
+  std::vector<char> m_seed;
+  std::unordered_map<std::thread::id, vk::PipelineCache> m_caches;
+  std::mutex m_lock;
+};
+}  // namespace ovk
+}  // namespace ohm
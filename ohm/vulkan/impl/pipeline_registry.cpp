@@ -0,0 +1,96 @@
+#include "ohm/vulkan/impl/pipeline_registry.h"
+#include <cstring>
+
+namespace ohm {
+namespace ovk {
+template <typename Type>
+inline auto append(std::string& key, Type value) -> void {
+  auto* ptr = reinterpret_cast<const char*>(&value);
+  key.append(ptr, sizeof(Type));
+}
+
+inline auto append(std::string& key, const std::string& str) -> void {
+  append<uint64_t>(key, str.size());
+  key.append(str);
+}
+
+inline auto append_bytes(std::string& key, const void* data, size_t size)
+    -> void {
+  append<uint64_t>(key, size);
+  key.append(static_cast<const char*>(data), size);
+}
+
+auto PipelineRegistry::key(int gpu, int32_t rp_handle,
+                           const PipelineInfo& info) -> std::string {
+  auto key = std::string();
+  append<int32_t>(key, gpu);
+  append<int32_t>(key, rp_handle);
+  append<int32_t>(key, static_cast<int32_t>(info.topology));
+  append<uint8_t>(key, info.depth_test);
+  append<uint8_t>(key, info.stencil_test);
+
+  append<uint64_t>(key, info.viewports.size());
+  for (auto& viewport : info.viewports) {
+    append<uint64_t>(key, viewport.width);
+    append<uint64_t>(key, viewport.height);
+    append<uint64_t>(key, viewport.x_pos);
+    append<uint64_t>(key, viewport.y_pos);
+    append<uint64_t>(key, viewport.max_depth);
+  }
+
+  // Every source is keyed, even those a pipeline won't use, so infos only
+  // match when they are the same everywhere.
+  append(key, info.file_name);
+  append<uint64_t>(key, info.inline_files.size());
+  for (auto& file : info.inline_files) {
+    append(key, file.first);
+    append(key, file.second);
+  }
+
+  append<uint64_t>(key, info.spirv.size());
+  for (auto& module : info.spirv) {
+    append(key, module.first);
+    append_bytes(key, module.second.data(),
+                 module.second.size() * sizeof(uint32_t));
+  }
+
+  append<uintptr_t>(key, reinterpret_cast<uintptr_t>(info.shader.get()));
+
+  append<uint64_t>(key, info.specialization.size());
+  for (auto& constant : info.specialization) {
+    append<uint32_t>(key, constant.first);
+    append<uint64_t>(key, constant.second);
+  }
+  return key;
+}
+
+auto PipelineRegistry::acquire(const std::string& key) -> int32_t {
+  auto iter = this->m_handles.find(key);
+  if (iter == this->m_handles.end()) return -1;
+
+  this->m_entries[iter->second].references++;
+  return iter->second;
+}
+
+auto PipelineRegistry::insert(const std::string& key, int32_t handle)
+    -> void {
+  this->m_handles[key] = handle;
+  this->m_entries[handle] = {key, 1};
+}
+
+auto PipelineRegistry::release(int32_t handle) -> bool {
+  auto iter = this->m_entries.find(handle);
+  if (iter == this->m_entries.end()) return false;
+
+  if (--iter->second.references != 0) return true;
+  this->m_handles.erase(iter->second.key);
+  this->m_entries.erase(iter);
+  return false;
+}
+
+auto PipelineRegistry::clear() -> void {
+  this->m_handles.clear();
+  this->m_entries.clear();
+}
+}  // namespace ovk
+}  // namespace ohm
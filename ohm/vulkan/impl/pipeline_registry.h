@@ -0,0 +1,57 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include "ohm/api/pipeline.h"
+namespace ohm {
+namespace ovk {
+/** Object to share pipelines made from identical creation state. Each shared
+ * handle is reference counted, and forgotten once its last reference is
+ * released.
+ * @note Only used from the thread owning the system's tables.
+ */
+class PipelineRegistry {
+ public:
+  PipelineRegistry() = default;
+  PipelineRegistry(const PipelineRegistry& cpy) = delete;
+  ~PipelineRegistry() = default;
+  auto operator=(const PipelineRegistry& cpy) -> PipelineRegistry& = delete;
+
+  /** Method to build the key of a pipeline's creation state. Shader sources
+   * and SPIR-V are stored whole, so only identical inputs share a key, and
+   * loaded shaders are keyed by address, which stays valid while a pipeline
+   * holds them.
+   * @param gpu The device, or -1 when a render pass is given.
+   * @param rp_handle The render pass handle, or -1 for compute pipelines.
+   */
+  static auto key(int gpu, int32_t rp_handle, const PipelineInfo& info)
+      -> std::string;
+
+  /** Method to find a shared pipeline, adding a reference to it.
+   * @return The pipeline's handle, or -1 if there is none.
+   */
+  auto acquire(const std::string& key) -> int32_t;
+
+  /** Method to share a newly created pipeline, holding one reference.
+   */
+  auto insert(const std::string& key, int32_t handle) -> void;
+
+  /** Method to drop a reference to a pipeline.
+   * @return Whether the pipeline is still referenced, and so must be kept.
+   * Always false for pipelines that aren't shared.
+   */
+  auto release(int32_t handle) -> bool;
+
+  auto clear() -> void;
+
+ private:
+  struct Entry {
+    std::string key;
+    unsigned references;
+  };
+
+  std::unordered_map<std::string, int32_t> m_handles;
+  std::unordered_map<int32_t, Entry> m_entries;
+};
+}  // namespace ovk
+}  // namespace ohm
@@ -0,0 +1,188 @@
+#define VULKAN_HPP_ASSERT_ON_RESULT
+#define VULKAN_HPP_STORAGE_SHARED_EXPORT
+#define VULKAN_HPP_STORAGE_SHARED
+#define VULKAN_HPP_NO_DEFAULT_DISPATCHER
+#define VULKAN_HPP_NO_EXCEPTIONS
+
+#include "ohm/vulkan/impl/profiler.h"
+#include <array>
+#include <vulkan/vulkan.hpp>
+#include "ohm/api/exception.h"
+#include "ohm/vulkan/impl/device.h"
+#include "ohm/vulkan/impl/error.h"
+
+namespace ohm {
+namespace ovk {
+// Vertex, fragment and compute invocations, reported in that (bit) order.
+constexpr auto STATISTIC_COUNT = 3u;
+constexpr auto graphics_statistic_flags =
+    vk::QueryPipelineStatisticFlagBits::eVertexShaderInvocations |
+    vk::QueryPipelineStatisticFlagBits::eFragmentShaderInvocations |
+    vk::QueryPipelineStatisticFlagBits::eComputeShaderInvocations;
+
+// Graphics statistics can't be queried on queues without graphics support.
+constexpr auto compute_statistic_flags =
+    vk::QueryPipelineStatisticFlags(
+        vk::QueryPipelineStatisticFlagBits::eComputeShaderInvocations);
+
+/** Queues with no valid timestamp bits can't write timestamps at all, so
+ * their scopes only get statistics and report zero milliseconds.
+ */
+Profiler::Profiler(Device& device, unsigned family, unsigned buffer_count,
+                   bool statistics) {
+  auto info = vk::QueryPoolCreateInfo();
+  auto vk_device = device.device();
+  auto* alloc_cb = device.allocationCB();
+  auto& dispatch = device.dispatch();
+  auto& families = device.families();
+  auto known = family < families.size();
+  auto bits = known ? families[family].timestampValidBits : 0u;
+
+  this->m_graphics =
+      known && (families[family].queueFlags & vk::QueueFlagBits::eGraphics);
+  this->m_device = &device;
+  this->m_period = device.limits().timestampPeriod;
+  this->m_mask = bits >= 64 ? ~uint64_t(0) : (uint64_t(1) << bits) - 1;
+  this->m_pending.resize(buffer_count, false);
+
+  info.setQueryType(vk::QueryType::eTimestamp);
+  info.setQueryCount(MAX_SCOPES * 2);
+  for (auto index = 0u; index < buffer_count && bits != 0; index++) {
+    this->m_timestamps.push_back(
+        error(vk_device.createQueryPool(info, alloc_cb, dispatch)));
+  }
+
+  if (statistics && device.enabledFeatures().pipelineStatisticsQuery) {
+    info.setQueryType(vk::QueryType::ePipelineStatistics);
+    info.setQueryCount(MAX_SCOPES);
+    info.setPipelineStatistics(this->m_graphics ? graphics_statistic_flags
+                                                : compute_statistic_flags);
+    for (auto index = 0u; index < buffer_count; index++) {
+      this->m_statistics.push_back(
+          error(vk_device.createQueryPool(info, alloc_cb, dispatch)));
+    }
+  }
+}
+
+Profiler::~Profiler() {
+  auto device = this->m_device->device();
+  auto* alloc_cb = this->m_device->allocationCB();
+  auto& dispatch = this->m_device->dispatch();
+
+  for (auto pool : this->m_timestamps) device.destroy(pool, alloc_cb, dispatch);
+  for (auto pool : this->m_statistics) device.destroy(pool, alloc_cb, dispatch);
+
+  this->m_timestamps.clear();
+  this->m_statistics.clear();
+}
+
+auto Profiler::reset(vk::CommandBuffer cmd, unsigned index) -> void {
+  auto& dispatch = this->m_device->dispatch();
+  if (!this->m_timestamps.empty())
+    cmd.resetQueryPool(this->m_timestamps[index], 0, MAX_SCOPES * 2, dispatch);
+  if (!this->m_statistics.empty())
+    cmd.resetQueryPool(this->m_statistics[index], 0, MAX_SCOPES, dispatch);
+}
+
+auto Profiler::begin(vk::CommandBuffer cmd, unsigned index, unsigned scope)
+    -> void {
+  auto& dispatch = this->m_device->dispatch();
+  if (!this->m_timestamps.empty())
+    cmd.writeTimestamp(vk::PipelineStageFlagBits::eTopOfPipe,
+                       this->m_timestamps[index], scope * 2, dispatch);
+
+  // Statistics queries of one pool can't nest, so only outermost scopes get
+  // them.
+  if (!this->m_statistics.empty() && this->m_scopes[scope].depth == 0)
+    cmd.beginQuery(this->m_statistics[index], scope, {}, dispatch);
+}
+
+auto Profiler::end(vk::CommandBuffer cmd, unsigned index, unsigned scope)
+    -> void {
+  auto& dispatch = this->m_device->dispatch();
+  if (!this->m_statistics.empty() && this->m_scopes[scope].depth == 0)
+    cmd.endQuery(this->m_statistics[index], scope, dispatch);
+
+  if (!this->m_timestamps.empty())
+    cmd.writeTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe,
+                       this->m_timestamps[index], scope * 2 + 1, dispatch);
+}
+
+auto Profiler::push(std::string_view name) -> unsigned {
+  if (this->m_scopes.size() >= MAX_SCOPES) return MAX_SCOPES;
+
+  auto scope = static_cast<unsigned>(this->m_scopes.size());
+  this->m_scopes.push_back({std::string(name),
+                            static_cast<unsigned>(this->m_open.size())});
+  this->m_open.push_back(scope);
+  return scope;
+}
+
+auto Profiler::pop() -> unsigned {
+  if (this->m_open.empty()) return MAX_SCOPES;
+
+  auto scope = this->m_open.back();
+  this->m_open.pop_back();
+  return scope;
+}
+
+auto Profiler::clear() -> void {
+  this->m_scopes.clear();
+  this->m_open.clear();
+}
+
+auto Profiler::submitted(unsigned index) -> void {
+  this->m_pending[index] = true;
+}
+
+auto Profiler::resolve(unsigned index) -> void {
+  using Statistics = std::array<uint64_t, STATISTIC_COUNT>;
+  auto device = this->m_device->device();
+  auto& dispatch = this->m_device->dispatch();
+  auto count = static_cast<unsigned>(this->m_scopes.size());
+
+  if (!this->m_pending[index] || count == 0) return;
+
+  auto timestamps = std::vector<uint64_t>(count * 2);
+  auto statistics = std::vector<Statistics>(count, Statistics{});
+
+  // Scopes left open have no end timestamp, so a partial result isn't waited
+  // on. The buffer stays pending, to be read again once it's complete.
+  auto result = vk::Result::eSuccess;
+  if (!this->m_timestamps.empty()) {
+    result = device.getQueryPoolResults(
+        this->m_timestamps[index], 0, count * 2,
+        timestamps.size() * sizeof(uint64_t), timestamps.data(),
+        sizeof(uint64_t), vk::QueryResultFlagBits::e64, dispatch);
+    if (result != vk::Result::eSuccess) return;
+  }
+
+  // Compute-only queues report just the compute invocations, which go last.
+  const auto has_statistics = !this->m_statistics.empty();
+  const auto first = this->m_graphics ? 0u : STATISTIC_COUNT - 1;
+  const auto size = (STATISTIC_COUNT - first) * sizeof(uint64_t);
+  for (auto scope = 0u; scope < count && has_statistics; scope++) {
+    if (this->m_scopes[scope].depth != 0) continue;
+    result = device.getQueryPoolResults(
+        this->m_statistics[index], scope, 1, size,
+        statistics[scope].data() + first, size,
+        vk::QueryResultFlagBits::e64, dispatch);
+    if (result != vk::Result::eSuccess) statistics[scope] = {};
+  }
+
+  this->m_pending[index] = false;
+
+  this->m_results.resize(count);
+  for (auto scope = 0u; scope < count; scope++) {
+    auto& timing = this->m_results[scope];
+    auto ticks =
+        (timestamps[scope * 2 + 1] - timestamps[scope * 2]) & this->m_mask;
+    timing.name = this->m_scopes[scope].name;
+    timing.milliseconds = static_cast<double>(ticks) * this->m_period / 1e6;
+    timing.vertex_invocations = statistics[scope][0];
+    timing.fragment_invocations = statistics[scope][1];
+    timing.compute_invocations = statistics[scope][2];
+  }
+}
+}  // namespace ovk
+}  // namespace ohm
@@ -0,0 +1,91 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+#include "ohm/api/commands.h"
+namespace ohm {
+namespace ovk {
+constexpr auto MAX_SCOPES = 256u;
+class Device;
+
+/** Object to manage the query pools used to time scopes of a command buffer.
+ * Every command buffer in the ring gets its own pools, since each one is in
+ * flight independently. Results are read back once that buffer's fence has
+ * been waited on, so resolving never stalls the GPU.
+ */
+class Profiler {
+ public:
+  Profiler(Device& device, unsigned family, unsigned buffer_count,
+           bool statistics);
+  Profiler(const Profiler& cpy) = delete;
+  ~Profiler();
+  auto operator=(const Profiler& cpy) -> Profiler& = delete;
+
+  /** Method to record a reset of the queries used by one command buffer.
+   * @param cmd The command buffer to record into.
+   * @param index The index of the command buffer in the ring.
+   */
+  auto reset(vk::CommandBuffer cmd, unsigned index) -> void;
+
+  /** Method to record the start of a scope.
+   * @param cmd The command buffer to record into.
+   * @param index The index of the command buffer in the ring.
+   * @param scope The scope from push().
+   */
+  auto begin(vk::CommandBuffer cmd, unsigned index, unsigned scope) -> void;
+
+  /** Method to record the end of a scope.
+   * @param cmd The command buffer to record into.
+   * @param index The index of the command buffer in the ring.
+   * @param scope The scope from pop().
+   */
+  auto end(vk::CommandBuffer cmd, unsigned index, unsigned scope) -> void;
+
+  /** Method to open a new scope.
+   * @return The scope's id, or MAX_SCOPES if the pools are full.
+   */
+  auto push(std::string_view name) -> unsigned;
+
+  /** Method to close the innermost open scope.
+   * @return The scope's id, or MAX_SCOPES if there was none to close.
+   */
+  auto pop() -> unsigned;
+
+  /** Method to forget the scopes of the previous recording.
+   */
+  auto clear() -> void;
+
+  /** Method to mark a command buffer as submitted, with results to resolve.
+   */
+  auto submitted(unsigned index) -> void;
+
+  /** Method to read back the results of a command buffer.
+   * @note Must only be called once that command buffer's fence has signaled.
+   */
+  auto resolve(unsigned index) -> void;
+
+  inline auto results() const -> const std::vector<ScopeTiming>& {
+    return this->m_results;
+  }
+
+ private:
+  struct Scope {
+    std::string name;
+    unsigned depth;
+  };
+
+  Device* m_device;
+  std::vector<vk::QueryPool> m_timestamps;
+  std::vector<vk::QueryPool> m_statistics;
+  std::vector<bool> m_pending;
+  std::vector<Scope> m_scopes;
+  std::vector<unsigned> m_open;
+  std::vector<ScopeTiming> m_results;
+  double m_period;
+  uint64_t m_mask;
+  bool m_graphics;
+};
+}  // namespace ovk
+}  // namespace ohm
@@ -5,6 +5,7 @@
 #define VULKAN_HPP_NO_EXCEPTIONS
 
 #include "ohm/vulkan/impl/shader.h"
+#include <algorithm>
 #include <fstream>
 #include <istream>
 #include <map>
@@ -12,6 +13,7 @@
 #include <vulkan/vulkan.hpp>
 #include "ohm/io/shader.h"
 #include "ohm/vulkan/impl/buffer.h"
+#include "ohm/vulkan/impl/descriptor_heap.h"
 #include "ohm/vulkan/impl/device.h"
 #include "ohm/vulkan/impl/error.h"
 #include "ohm/vulkan/impl/image.h"
@@ -138,12 +140,16 @@ auto convert(vk::ShaderStageFlagBits flag) -> io::ShaderType {
   }
 }
 
-Shader::Shader() { this->m_rate = vk::VertexInputRate::eVertex; }
+Shader::Shader() {
+  this->m_rate = vk::VertexInputRate::eVertex;
+  this->m_push_constant_size = 0;
+}
 
 Shader::Shader(Device& device, std::string_view path) {
   this->m_rate = vk::VertexInputRate::eVertex;
+  this->m_push_constant_size = 0;
   this->m_device = &device;
-  this->m_file = std::make_unique<io::Shader>(path);
+  this->m_file = std::make_shared<io::Shader>(path);
 
   this->parse();
   this->makeDescriptorLayout();
@@ -154,8 +160,36 @@ Shader::Shader(Device& device, std::string_view path) {
 Shader::Shader(Device& device,
                std::vector<std::pair<std::string, std::string>> inline_files) {
   this->m_rate = vk::VertexInputRate::eVertex;
+  this->m_push_constant_size = 0;
+  this->m_device = &device;
+  this->m_file = std::make_shared<io::Shader>(inline_files);
+
+  this->parse();
+  this->makeDescriptorLayout();
+  this->makeShaderModules();
+  this->makePipelineShaderInfos();
+}
+
+Shader::Shader(
+    Device& device,
+    std::vector<std::pair<std::string, std::vector<uint32_t>>> spirv) {
+  this->m_rate = vk::VertexInputRate::eVertex;
+  this->m_push_constant_size = 0;
   this->m_device = &device;
-  this->m_file = std::make_unique<io::Shader>(inline_files);
+  this->m_file = std::make_shared<io::Shader>(spirv);
+
+  this->parse();
+  this->makeDescriptorLayout();
+  this->makeShaderModules();
+  this->makePipelineShaderInfos();
+}
+
+Shader::Shader(Device& device, std::shared_ptr<const io::Shader> file) {
+  OhmAssert(!file, "Creating a pipeline from a null shader.");
+  this->m_rate = vk::VertexInputRate::eVertex;
+  this->m_push_constant_size = 0;
+  this->m_device = &device;
+  this->m_file = std::move(file);
 
   this->parse();
   this->makeDescriptorLayout();
@@ -182,6 +216,51 @@ Shader::~Shader() {
   this->m_infos.clear();
 }
 
+auto Shader::shaderInfos(const std::map<uint32_t, uint64_t>& constants,
+                         Specialization& storage) const
+    -> std::vector<vk::PipelineShaderStageCreateInfo> {
+  auto infos = this->m_infos;
+  if (constants.empty()) return infos;
+
+  // Sized up front, since the infos point into these.
+  storage.infos.resize(infos.size());
+  storage.entries.resize(infos.size());
+  storage.data.resize(infos.size());
+
+  // Infos are made in module order, so they share an index.
+  auto index = 0u;
+  for (auto& module : this->m_modules) {
+    auto& entries = storage.entries[index];
+    auto& data = storage.data[index];
+
+    for (auto& stage : this->m_file->stages()) {
+      if (stage.type != module.first) continue;
+      for (auto& constant : stage.spec_constants) {
+        auto value = constants.find(constant.id);
+        if (value == constants.end()) continue;
+
+        auto entry = vk::SpecializationMapEntry();
+        entry.setConstantID(constant.id);
+        entry.setOffset(static_cast<uint32_t>(data.size()));
+        entry.setSize(constant.size);
+        entries.push_back(entry);
+
+        auto* bits = reinterpret_cast<const char*>(&value->second);
+        data.insert(data.end(), bits, bits + constant.size);
+      }
+    }
+
+    if (!entries.empty()) {
+      storage.infos[index].setMapEntries(entries);
+      storage.infos[index].setDataSize(data.size());
+      storage.infos[index].setPData(data.data());
+      infos[index].setPSpecializationInfo(&storage.infos[index]);
+    }
+    index++;
+  }
+  return infos;
+}
+
 auto Shader::parse() -> void {
   auto binding_map = std::map<std::string, vk::DescriptorSetLayoutBinding>();
   auto binding = vk::DescriptorSetLayoutBinding();
@@ -189,6 +268,9 @@ auto Shader::parse() -> void {
   auto attr = vk::VertexInputAttributeDescription();
   auto bind = vk::VertexInputBindingDescription();
 
+  // The heap's variables are in its own layout.
+  const auto bindless = this->m_device->heap() != nullptr;
+
   auto offset = 0u;
   for (auto& stage : this->m_file->stages()) {
     for (auto& attribute : stage.in_attributes) {
@@ -202,6 +284,7 @@ auto Shader::parse() -> void {
     }
 
     for (auto& variable : stage.variables) {
+      if (bindless && variable.second.set == BINDLESS_SET) continue;
       auto iter = binding_map.find(variable.first);
       if (iter != binding_map.end()) {
         auto& flags = iter->second.stageFlags;
@@ -215,6 +298,13 @@ auto Shader::parse() -> void {
         binding_map.insert(iter, {variable.first, binding});
       }
     }
+    for (auto& push_constant : stage.push_constants) {
+      auto end = push_constant.offset + push_constant.size;
+      this->m_push_constant_flags |= convert(stage.type);
+      this->m_push_constant_size =
+          std::max<unsigned>(this->m_push_constant_size, end);
+    }
+
     module_info.setCodeSize(stage.spirv.size() * sizeof(unsigned));
     module_info.setPCode(stage.spirv.data());
     this->m_spirv_map[convert(stage.type)] = module_info;
@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <string>
@@ -17,11 +18,22 @@ class Shader {
     Instanced,
   };
 
+  /** Storage a pipeline's specialization must keep alive while creating it.
+   */
+  struct Specialization {
+    std::vector<vk::SpecializationInfo> infos;
+    std::vector<std::vector<vk::SpecializationMapEntry>> entries;
+    std::vector<std::vector<char>> data;
+  };
+
   Shader();
   Shader(const Shader& shader);
   Shader(Device& device, std::string_view path);
   Shader(Device& device,
          std::vector<std::pair<std::string, std::string>> inline_files);
+  Shader(Device& device,
+         std::vector<std::pair<std::string, std::vector<uint32_t>>> spirv);
+  Shader(Device& device, std::shared_ptr<const io::Shader> file);
   Shader(Shader&& mv);
   ~Shader();
   Shader& operator=(Shader&& mv);
@@ -48,11 +60,26 @@ class Shader {
     return this->m_infos;
   }
 
+  /** Method to retrieve the stage infos, with the given specialization
+   * constant IDs overridden in every stage declaring them.
+   */
+  auto shaderInfos(const std::map<uint32_t, uint64_t>& constants,
+                   Specialization& storage) const
+      -> std::vector<vk::PipelineShaderStageCreateInfo>;
+
   auto descriptorLayouts() const
       -> const std::vector<vk::DescriptorSetLayoutBinding>& {
     return this->m_descriptors;
   }
 
+  auto pushConstantSize() const -> unsigned {
+    return this->m_push_constant_size;
+  }
+
+  auto pushConstantFlags() const -> vk::ShaderStageFlags {
+    return this->m_push_constant_flags;
+  }
+
  private:
   using SPIRVMap =
       std::map<vk::ShaderStageFlagBits, vk::ShaderModuleCreateInfo>;
@@ -68,11 +95,13 @@ class Shader {
   Attributes m_inputs;
   Bindings m_bindings;
   Infos m_infos;
-  std::unique_ptr<io::Shader> m_file;
+  std::shared_ptr<const io::Shader> m_file;
   Device* m_device;
   vk::DescriptorSetLayout m_layout;
   vk::PipelineVertexInputStateCreateInfo m_info;
   vk::VertexInputRate m_rate;
+  vk::ShaderStageFlags m_push_constant_flags;
+  unsigned m_push_constant_size;
 
   inline auto parse() -> void;
   inline auto makeDescriptorLayout() -> void;
@@ -1,4 +1,5 @@
 #pragma once
+#include <future>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -18,6 +19,7 @@
 #include "ohm/vulkan/impl/instance.h"
 #include "ohm/vulkan/impl/memory.h"
 #include "ohm/vulkan/impl/pipeline.h"
+#include "ohm/vulkan/impl/pipeline_registry.h"
 #include "ohm/vulkan/impl/swapchain.h"
 #include "ohm/vulkan/impl/window.h"
 namespace ohm {
@@ -30,6 +32,8 @@ struct System {
   Instance instance;
   std::vector<std::string> device_extensions;
   std::vector<std::string> validation_layers;
+  std::string pipeline_cache_dir;
+  bool bindless;
   std::vector<ovk::Device> devices;
   std::vector<ohm::Gpu> gpus;
 
@@ -45,7 +49,17 @@ struct System {
   vk::AllocationCallbacks* allocate_cb;
   std::unordered_map<int32_t, std::shared_ptr<Event>> event;
 
+  // Pipelines still being built in the background, by their reserved handle.
+  std::unordered_map<int32_t, std::future<Pipeline>> pending_pipeline;
+
+  // Pipelines made with create_shared, by their creation state.
+  PipelineRegistry pipeline_registry;
+
   auto shutdown() -> void {
+    for (auto& pending : this->pending_pipeline) pending.second.wait();
+    this->pending_pipeline.clear();
+    this->pipeline_registry.clear();
+
     this->swapchain.clear();
     this->window.clear();
     this->image.clear();
@@ -80,6 +94,7 @@ struct System {
     this->device_extensions.clear();
     this->devices.clear();
     this->allocate_cb = nullptr;
+    this->bindless = false;
   }
 
   ~System() { this->shutdown(); }
@@ -8,13 +8,20 @@
 #include <SDL.h>
 #include <atomic>
 #include <algorithm>
+#include <chrono>
+#include <future>
 #include <memory>
+#include <thread>
 #include <utility>
 #include "impl/swapchain.h"
 #include "ohm/api/exception.h"
 #include "ohm/api/memory.h"
 #include "ohm/api/system.h"
+#include "ohm/io/jobs.h"
+#include "ohm/io/trace.h"
+#include "ohm/vulkan/impl/descriptor_heap.h"
 #include "ohm/vulkan/impl/error.h"
+#include "ohm/vulkan/impl/pipeline_cache.h"
 #include "ohm/vulkan/impl/system.h"
 #ifdef __linux__
 #include <stdlib.h>
@@ -26,6 +33,7 @@
 namespace ohm {
 inline namespace v1 {
 auto Vulkan::System::initialize() Ohm_NOEXCEPT -> void {
+  OhmTraceZone("Vulkan::System::initialize");
   auto& loader = ovk::system().loader;
   if (!loader.initialized()) {
 #ifdef _WIN32
@@ -43,6 +51,9 @@ auto Vulkan::System::initialize() Ohm_NOEXCEPT -> void {
       for (auto& extension : ovk::system().device_extensions) {
         device.addExtension(extension.c_str());
       }
+      if (ovk::system().bindless) {
+        device.addExtension(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+      }
 
       for (auto& validation : ovk::system().validation_layers) {
         device.addValidation(validation.c_str());
@@ -61,6 +72,12 @@ auto Vulkan::System::initialize() Ohm_NOEXCEPT -> void {
       gpu.name = ovk::system().devices[index].name();
       ovk::system().gpus.emplace_back(std::move(gpu));
     }
+
+    if (!ovk::system().pipeline_cache_dir.empty()) {
+      for (auto& device : ovk::system().devices) {
+        device.pipelineCache().load(ovk::system().pipeline_cache_dir);
+      }
+    }
   }
 }
 
@@ -75,6 +92,7 @@ auto Vulkan::System::name() Ohm_NOEXCEPT -> std::string {
 }
 
 auto Vulkan::System::shutdown() Ohm_NOEXCEPT -> void {
+  Vulkan::System::save_pipeline_cache();
   ovk::system().shutdown();
 }
 
@@ -88,6 +106,23 @@ auto Vulkan::System::set_debug_parameter(std::string_view str) Ohm_NOEXCEPT
   ovk::system().instance.addValidationLayer(str.cbegin());
 }
 
+auto Vulkan::System::set_pipeline_cache(std::string_view directory)
+    Ohm_NOEXCEPT -> void {
+  ovk::system().pipeline_cache_dir = std::string(directory);
+}
+
+auto Vulkan::System::save_pipeline_cache() Ohm_NOEXCEPT -> void {
+  OhmTraceZone("Vulkan::System::save_pipeline_cache");
+  if (ovk::system().pipeline_cache_dir.empty()) return;
+  for (auto& device : ovk::system().devices) {
+    device.pipelineCache().save(ovk::system().pipeline_cache_dir);
+  }
+}
+
+auto Vulkan::System::set_bindless(bool enable) Ohm_NOEXCEPT -> void {
+  ovk::system().bindless = enable;
+}
+
 auto Vulkan::System::devices() Ohm_NOEXCEPT -> std::vector<Gpu> {
   return ovk::system().gpus;
 }
@@ -101,6 +136,7 @@ auto Vulkan::Memory::heaps(int gpu) Ohm_NOEXCEPT
 //@JH TODO would like to simplify this as its a bit messy.
 auto Vulkan::Memory::allocate(int gpu, HeapType requested, size_t heap_index,
                               size_t size) Ohm_NOEXCEPT -> int32_t {
+  OhmTraceZone("Vulkan::Memory::allocate");
   auto& device = ovk::system().devices[gpu];
   auto mem_type_count = device.memoryProperties().memoryTypeCount;
   auto index = 0;
@@ -177,6 +213,7 @@ auto Vulkan::Memory::offset(int32_t handle, size_t offset) Ohm_NOEXCEPT
 
 auto Vulkan::Array::create(int gpu, size_t num_elmts,
                            size_t elm_size) Ohm_NOEXCEPT -> int32_t {
+  OhmTraceZone("Vulkan::Array::create");
   auto& device = ovk::system().devices[gpu];
   auto index = 0;
   for (auto& buf : ovk::system().buffer) {
@@ -198,6 +235,10 @@ auto Vulkan::Array::destroy(int32_t handle) Ohm_NOEXCEPT -> void {
 
   OhmAssert(!buf.initialized(),
             "Attempting to use array object that is not initialized.");
+
+  using Binding = ovk::DescriptorHeap::Binding;
+  auto* heap = buf.device().heap();
+  if (heap) heap->erase(Binding::Arrays, handle);
   tmp = std::move(buf);
 }
 
@@ -220,6 +261,19 @@ auto Vulkan::Array::bind(int32_t array_handle,
   OhmAssert(!buf.initialized(),
             "Attempting to use array object that is not initialized.");
   buf.bind(mem);
+
+  auto* heap = buf.device().heap();
+  if (heap) heap->insert(array_handle, buf);
+}
+
+auto Vulkan::Array::bindless(int32_t handle) Ohm_NOEXCEPT -> int32_t {
+  if (handle < 0) return -1;
+  auto& buf = ovk::system().buffer[handle];
+  if (!buf.initialized()) return -1;
+
+  using Binding = ovk::DescriptorHeap::Binding;
+  auto* heap = buf.device().heap();
+  return heap && heap->written(Binding::Arrays, handle) ? handle : -1;
 }
 
 auto Vulkan::Image::create(int gpu, const ImageInfo& info) Ohm_NOEXCEPT
@@ -245,6 +299,13 @@ auto Vulkan::Image::destroy(int32_t handle) Ohm_NOEXCEPT -> void {
 
   OhmAssert(!val.initialized(),
             "Attempting to use image object that is not initialized.");
+
+  using Binding = ovk::DescriptorHeap::Binding;
+  auto* heap = val.device().heap();
+  if (heap) {
+    heap->erase(Binding::Sampled, handle);
+    heap->erase(Binding::Storage, handle);
+  }
   tmp = std::move(val);
 }
 
@@ -256,6 +317,8 @@ auto Vulkan::Image::layer(int32_t handle, size_t layer) Ohm_NOEXCEPT
   for (auto& val : ovk::system().image) {
     if (!val.initialized()) {
       val = std::move(ovk::Image(parent, layer));
+      auto* heap = val.device().heap();
+      if (heap) heap->insert(index, val);
       return index;
     }
     index++;
@@ -287,6 +350,21 @@ auto Vulkan::Image::bind(int32_t handle, int32_t mem_handle) Ohm_NOEXCEPT
   OhmAssert(!mem.initialized(),
             "Attempting to use memory object that is not initialized.");
   val.bind(mem);
+
+  auto* heap = val.device().heap();
+  if (heap) heap->insert(handle, val);
+}
+
+auto Vulkan::Image::bindless(int32_t handle) Ohm_NOEXCEPT -> int32_t {
+  if (handle < 0) return -1;
+  auto& val = ovk::system().image[handle];
+  if (!val.initialized()) return -1;
+
+  using Binding = ovk::DescriptorHeap::Binding;
+  auto* heap = val.device().heap();
+  auto written = heap && (heap->written(Binding::Sampled, handle) ||
+                          heap->written(Binding::Storage, handle));
+  return written ? handle : -1;
 }
 
 auto Vulkan::Commands::create(int gpu, QueueType type) Ohm_NOEXCEPT -> int32_t {
@@ -305,11 +383,106 @@ auto Vulkan::Commands::create(int gpu, QueueType type) Ohm_NOEXCEPT -> int32_t {
 }
 
 auto Vulkan::Commands::draw(int32_t handle, int32_t vertices, size_t instance_count) Ohm_NOEXCEPT -> void {
+  OhmAssert(handle < 0, "Attempting to use an invalid commands handle.");
+  OhmAssert(vertices < 0, "Attempting to use an invalid vertex array handle.");
+  auto& cmd = ovk::system().commands[handle];
+  auto& vert = ovk::system().buffer[vertices];
 
+  OhmAssert(!cmd.initialized(),
+            "Attempting to use object that is not initialized.");
+  cmd.draw(vert, instance_count);
 }
 
 auto Vulkan::Commands::draw_indexed(int32_t handle, int32_t indices, int32_t vertices, size_t instance_count) Ohm_NOEXCEPT -> void {
+  OhmAssert(handle < 0, "Attempting to use an invalid commands handle.");
+  OhmAssert(indices < 0, "Attempting to use an invalid index array handle.");
+  OhmAssert(vertices < 0, "Attempting to use an invalid vertex array handle.");
+  auto& cmd = ovk::system().commands[handle];
+  auto& ind = ovk::system().buffer[indices];
+  auto& vert = ovk::system().buffer[vertices];
+
+  OhmAssert(!cmd.initialized(),
+            "Attempting to use object that is not initialized.");
+  cmd.draw(ind, vert, instance_count);
+}
+
+auto Vulkan::Commands::draw_indirect(int32_t handle, int32_t vertices,
+                                     int32_t args, size_t draw_count,
+                                     size_t offset) Ohm_NOEXCEPT -> void {
+  OhmAssert(handle < 0, "Attempting to use an invalid commands handle.");
+  OhmAssert(vertices < 0, "Attempting to use an invalid vertex array handle.");
+  OhmAssert(args < 0, "Attempting to use an invalid argument array handle.");
+  auto& cmd = ovk::system().commands[handle];
+  auto& vert = ovk::system().buffer[vertices];
+  auto& arg = ovk::system().buffer[args];
 
+  OhmAssert(!cmd.initialized(),
+            "Attempting to use object that is not initialized.");
+  OhmAssert(offset + draw_count > arg.count(),
+            "Attempting to read indirect draws past the end of the array.");
+  cmd.drawIndirect(vert, arg, draw_count, offset);
+}
+
+auto Vulkan::Commands::draw_indirect_count(int32_t handle, int32_t vertices,
+                                           int32_t args, int32_t count,
+                                           size_t max_draws) Ohm_NOEXCEPT
+    -> void {
+  OhmAssert(handle < 0, "Attempting to use an invalid commands handle.");
+  OhmAssert(vertices < 0, "Attempting to use an invalid vertex array handle.");
+  OhmAssert(args < 0, "Attempting to use an invalid argument array handle.");
+  OhmAssert(count < 0, "Attempting to use an invalid count array handle.");
+  auto& cmd = ovk::system().commands[handle];
+  auto& vert = ovk::system().buffer[vertices];
+  auto& arg = ovk::system().buffer[args];
+  auto& cnt = ovk::system().buffer[count];
+
+  OhmAssert(!cmd.initialized(),
+            "Attempting to use object that is not initialized.");
+  OhmAssert(max_draws > arg.count(),
+            "Attempting to read indirect draws past the end of the array.");
+  cmd.drawIndirect(vert, arg, cnt, max_draws);
+}
+
+auto Vulkan::Commands::draw_indexed_indirect(int32_t handle, int32_t indices,
+                                             int32_t vertices, int32_t args,
+                                             size_t draw_count,
+                                             size_t offset) Ohm_NOEXCEPT
+    -> void {
+  OhmAssert(handle < 0, "Attempting to use an invalid commands handle.");
+  OhmAssert(indices < 0, "Attempting to use an invalid index array handle.");
+  OhmAssert(vertices < 0, "Attempting to use an invalid vertex array handle.");
+  OhmAssert(args < 0, "Attempting to use an invalid argument array handle.");
+  auto& cmd = ovk::system().commands[handle];
+  auto& ind = ovk::system().buffer[indices];
+  auto& vert = ovk::system().buffer[vertices];
+  auto& arg = ovk::system().buffer[args];
+
+  OhmAssert(!cmd.initialized(),
+            "Attempting to use object that is not initialized.");
+  OhmAssert(offset + draw_count > arg.count(),
+            "Attempting to read indirect draws past the end of the array.");
+  cmd.drawIndexedIndirect(ind, vert, arg, draw_count, offset);
+}
+
+auto Vulkan::Commands::draw_indexed_indirect_count(
+    int32_t handle, int32_t indices, int32_t vertices, int32_t args,
+    int32_t count, size_t max_draws) Ohm_NOEXCEPT -> void {
+  OhmAssert(handle < 0, "Attempting to use an invalid commands handle.");
+  OhmAssert(indices < 0, "Attempting to use an invalid index array handle.");
+  OhmAssert(vertices < 0, "Attempting to use an invalid vertex array handle.");
+  OhmAssert(args < 0, "Attempting to use an invalid argument array handle.");
+  OhmAssert(count < 0, "Attempting to use an invalid count array handle.");
+  auto& cmd = ovk::system().commands[handle];
+  auto& ind = ovk::system().buffer[indices];
+  auto& vert = ovk::system().buffer[vertices];
+  auto& arg = ovk::system().buffer[args];
+  auto& cnt = ovk::system().buffer[count];
+
+  OhmAssert(!cmd.initialized(),
+            "Attempting to use object that is not initialized.");
+  OhmAssert(max_draws > arg.count(),
+            "Attempting to read indirect draws past the end of the array.");
+  cmd.drawIndexedIndirect(ind, vert, arg, cnt, max_draws);
 }
 
 auto Vulkan::Commands::destroy(int32_t handle) Ohm_NOEXCEPT -> void {
@@ -412,6 +585,114 @@ auto Vulkan::Commands::copy_array(int32_t handle, const void* src, int32_t dst,
   cmd.copy(static_cast<const unsigned char*>(src), dst_buf, count);
 }
 
+auto Vulkan::Commands::copy_array(int32_t handle, int32_t src, int32_t dst,
+                                  const ArrayRegion* regions,
+                                  size_t region_count) Ohm_NOEXCEPT -> void {
+  OhmAssert(handle < 0, "Attempting to use an invalid commands handle.");
+  OhmAssert(src < 0, "Attempting to use an invalid src array handle.");
+  OhmAssert(dst < 0, "Attempting to use an invalid dst array handle.");
+  OhmAssert(regions == nullptr && region_count != 0,
+            "Attempting to copy from an invalid list of regions.");
+  auto& cmd = ovk::system().commands[handle];
+  auto& src_buf = ovk::system().buffer[src];
+  auto& dst_buf = ovk::system().buffer[dst];
+
+  OhmAssert(!cmd.initialized(),
+            "Attempting to use object that is not initialized.");
+  cmd.copy(src_buf, dst_buf, regions, region_count);
+}
+
+auto Vulkan::Commands::copy_to_image(int32_t handle, int32_t src, int32_t dst,
+                                     const ImageRegion* regions,
+                                     size_t region_count) Ohm_NOEXCEPT -> void {
+  OhmAssert(handle < 0, "Attempting to use an invalid commands handle.");
+  OhmAssert(src < 0, "Attempting to use an invalid src array handle.");
+  OhmAssert(dst < 0, "Attempting to use an invalid dst image handle.");
+  OhmAssert(regions == nullptr && region_count != 0,
+            "Attempting to copy from an invalid list of regions.");
+  auto& cmd = ovk::system().commands[handle];
+  auto& src_buf = ovk::system().buffer[src];
+  auto& dst_img = ovk::system().image[dst];
+
+  OhmAssert(!cmd.initialized(),
+            "Attempting to use object that is not initialized.");
+  cmd.copy(src_buf, dst_img, regions, region_count);
+}
+
+auto Vulkan::Commands::copy_from_image(int32_t handle, int32_t src, int32_t dst,
+                                       const ImageRegion* regions,
+                                       size_t region_count) Ohm_NOEXCEPT
+    -> void {
+  OhmAssert(handle < 0, "Attempting to use an invalid commands handle.");
+  OhmAssert(src < 0, "Attempting to use an invalid src image handle.");
+  OhmAssert(dst < 0, "Attempting to use an invalid dst array handle.");
+  OhmAssert(regions == nullptr && region_count != 0,
+            "Attempting to copy from an invalid list of regions.");
+  auto& cmd = ovk::system().commands[handle];
+  auto& src_img = ovk::system().image[src];
+  auto& dst_buf = ovk::system().buffer[dst];
+
+  OhmAssert(!cmd.initialized(),
+            "Attempting to use object that is not initialized.");
+  cmd.copy(src_img, dst_buf, regions, region_count);
+}
+
+auto Vulkan::Commands::copy_image(int32_t handle, int32_t src, int32_t dst,
+                                  const ImageCopyRegion* regions,
+                                  size_t region_count) Ohm_NOEXCEPT -> void {
+  OhmAssert(handle < 0, "Attempting to use an invalid commands handle.");
+  OhmAssert(src < 0, "Attempting to use an invalid src image handle.");
+  OhmAssert(dst < 0, "Attempting to use an invalid dst image handle.");
+  OhmAssert(regions == nullptr && region_count != 0,
+            "Attempting to copy from an invalid list of regions.");
+  auto& cmd = ovk::system().commands[handle];
+  auto& src_img = ovk::system().image[src];
+  auto& dst_img = ovk::system().image[dst];
+
+  OhmAssert(!cmd.initialized(),
+            "Attempting to use object that is not initialized.");
+  cmd.copy(src_img, dst_img, regions, region_count);
+}
+
+auto Vulkan::Commands::fill(int32_t handle, int32_t dst, uint32_t value,
+                            size_t offset, size_t count) Ohm_NOEXCEPT -> void {
+  OhmAssert(handle < 0, "Attempting to use an invalid commands handle.");
+  OhmAssert(dst < 0, "Attempting to use an invalid dst array handle.");
+  auto& cmd = ovk::system().commands[handle];
+  auto& dst_buf = ovk::system().buffer[dst];
+
+  OhmAssert(!cmd.initialized(),
+            "Attempting to use object that is not initialized.");
+  OhmAssert(offset + count > dst_buf.count(),
+            "Attempting to fill past the end of the array.");
+  cmd.fill(dst_buf, value, offset, count);
+}
+
+auto Vulkan::Commands::update(int32_t handle, int32_t dst, const void* src,
+                              size_t count, size_t offset) Ohm_NOEXCEPT
+    -> void {
+  OhmAssert(handle < 0, "Attempting to use an invalid commands handle.");
+  OhmAssert(dst < 0, "Attempting to use an invalid dst array handle.");
+  OhmAssert(src == nullptr, "Attempting to use an invalid src pointer.");
+  auto& cmd = ovk::system().commands[handle];
+  auto& dst_buf = ovk::system().buffer[dst];
+
+  OhmAssert(!cmd.initialized(),
+            "Attempting to use object that is not initialized.");
+  OhmAssert(offset + count > dst_buf.count(),
+            "Attempting to update past the end of the array.");
+  cmd.update(dst_buf, src, count, offset);
+}
+
+auto Vulkan::Commands::barrier(int32_t handle) Ohm_NOEXCEPT -> void {
+  OhmAssert(handle < 0, "Attempting to use an invalid commands handle.");
+  auto& cmd = ovk::system().commands[handle];
+
+  OhmAssert(!cmd.initialized(),
+            "Attempting to use object that is not initialized.");
+  cmd.barrier();
+}
+
 auto Vulkan::Commands::dispatch(int32_t handle, size_t x, size_t y,
                                 size_t z) Ohm_NOEXCEPT -> void {
   OhmAssert(handle < 0, "Attempting to use an invalid commands handle.");
@@ -422,6 +703,32 @@ auto Vulkan::Commands::dispatch(int32_t handle, size_t x, size_t y,
   cmd.dispatch(x, y, z);
 }
 
+auto Vulkan::Commands::dispatch_indirect(int32_t handle, int32_t args,
+                                         size_t offset) Ohm_NOEXCEPT -> void {
+  OhmAssert(handle < 0, "Attempting to use an invalid commands handle.");
+  OhmAssert(args < 0, "Attempting to use an invalid argument array handle.");
+  auto& cmd = ovk::system().commands[handle];
+  auto& arg = ovk::system().buffer[args];
+
+  OhmAssert(!cmd.initialized(),
+            "Attempting to use object that is not initialized.");
+  OhmAssert(offset >= arg.count(),
+            "Attempting to read a dispatch past the end of the array.");
+  cmd.dispatchIndirect(arg, offset);
+}
+
+auto Vulkan::Commands::push(int32_t handle, const void* data, size_t size,
+                            size_t offset) Ohm_NOEXCEPT -> void {
+  OhmAssert(handle < 0, "Attempting to use an invalid commands handle.");
+  OhmAssert(data == nullptr,
+            "Attempting to push constants from a null pointer.");
+  auto& cmd = ovk::system().commands[handle];
+
+  OhmAssert(!cmd.initialized(),
+            "Attempting to use object that is not initialized.");
+  cmd.pushConstants(data, size, offset);
+}
+
 auto Vulkan::Commands::blit_to_window(int32_t handle, int32_t src, int32_t dst,
                                       Filter filter) Ohm_NOEXCEPT -> void {
   OhmAssert(handle < 0, "Attempting to use an invalid commands handle.");
@@ -460,6 +767,7 @@ auto Vulkan::Commands::blit_from_renderpass(int32_t handle, int32_t src,
     -> void {}
 
 auto Vulkan::Commands::submit(int32_t handle) Ohm_NOEXCEPT -> void {
+  OhmTraceZone("Vulkan::Commands::submit");
   OhmAssert(handle < 0, "Attempting to use an invalid commands handle.");
   auto& cmd = ovk::system().commands[handle];
 
@@ -469,6 +777,7 @@ auto Vulkan::Commands::submit(int32_t handle) Ohm_NOEXCEPT -> void {
 }
 
 auto Vulkan::Commands::synchronize(int32_t handle) Ohm_NOEXCEPT -> void {
+  OhmTraceZone("Vulkan::Commands::synchronize");
   OhmAssert(handle < 0, "Attempting to use an invalid commands handle.");
   auto& cmd = ovk::system().commands[handle];
 
@@ -477,6 +786,55 @@ auto Vulkan::Commands::synchronize(int32_t handle) Ohm_NOEXCEPT -> void {
   cmd.synchronize();
 }
 
+auto Vulkan::Commands::skipped_binds(int32_t handle) Ohm_NOEXCEPT -> size_t {
+  OhmAssert(handle < 0, "Attempting to use an invalid commands handle.");
+  auto& cmd = ovk::system().commands[handle];
+
+  OhmAssert(!cmd.initialized(),
+            "Attempting to use object that is not initialized.");
+  return cmd.skippedBinds();
+}
+
+auto Vulkan::Commands::profile(int32_t handle, bool enable,
+                               bool statistics) Ohm_NOEXCEPT -> void {
+  OhmAssert(handle < 0, "Attempting to use an invalid commands handle.");
+  auto& cmd = ovk::system().commands[handle];
+
+  OhmAssert(!cmd.initialized(),
+            "Attempting to use object that is not initialized.");
+  cmd.profile(enable, statistics);
+}
+
+auto Vulkan::Commands::begin_scope(int32_t handle,
+                                   std::string_view name) Ohm_NOEXCEPT
+    -> void {
+  OhmAssert(handle < 0, "Attempting to use an invalid commands handle.");
+  auto& cmd = ovk::system().commands[handle];
+
+  OhmAssert(!cmd.initialized(),
+            "Attempting to use object that is not initialized.");
+  cmd.beginScope(name);
+}
+
+auto Vulkan::Commands::end_scope(int32_t handle) Ohm_NOEXCEPT -> void {
+  OhmAssert(handle < 0, "Attempting to use an invalid commands handle.");
+  auto& cmd = ovk::system().commands[handle];
+
+  OhmAssert(!cmd.initialized(),
+            "Attempting to use object that is not initialized.");
+  cmd.endScope();
+}
+
+auto Vulkan::Commands::scopes(int32_t handle) Ohm_NOEXCEPT
+    -> std::vector<ScopeTiming> {
+  OhmAssert(handle < 0, "Attempting to use an invalid commands handle.");
+  auto& cmd = ovk::system().commands[handle];
+
+  OhmAssert(!cmd.initialized(),
+            "Attempting to use object that is not initialized.");
+  return cmd.scopes();
+}
+
 auto Vulkan::RenderPass::create(int gpu,
                                 const RenderPassInfo& info) Ohm_NOEXCEPT
     -> int32_t {
@@ -521,12 +879,35 @@ auto Vulkan::RenderPass::image(int32_t handle, size_t index) -> int32_t {
   return pass.framebuffers()[index];
 }
 
+/** Whether a pipeline slot is reserved for a pipeline still being built.
+ */
+static auto pending(int32_t handle) -> bool {
+  return ovk::system().pending_pipeline.count(handle) != 0;
+}
+
+/** Reserves a free pipeline slot for a pipeline built by a background job.
+ */
+static auto reserve(std::future<ovk::Pipeline> future) -> int32_t {
+  auto index = 0;
+  for (auto& val : ovk::system().pipeline) {
+    if (!val.initialized() && !pending(index)) {
+      ovk::system().pending_pipeline[index] = std::move(future);
+      return index;
+    }
+    index++;
+  }
+
+  OhmAssert(true, "Too many pipelines. API has run out of allocation space.");
+  return -1;
+}
+
 auto Vulkan::Pipeline::create(int gpu, const PipelineInfo& info) Ohm_NOEXCEPT
     -> int32_t {
+  OhmTraceZone("Vulkan::Pipeline::create");
   auto& device = ovk::system().devices[gpu];
   auto index = 0;
   for (auto& pipe : ovk::system().pipeline) {
-    if (!pipe.initialized()) {
+    if (!pipe.initialized() && !pending(index)) {
       pipe = std::move(ovk::Pipeline(device, info));
       return index;
     }
@@ -540,10 +921,11 @@ auto Vulkan::Pipeline::create(int gpu, const PipelineInfo& info) Ohm_NOEXCEPT
 auto Vulkan::Pipeline::create_from_rp(int32_t rp_handle,
                                       const PipelineInfo& info) Ohm_NOEXCEPT
     -> int32_t {
+  OhmTraceZone("Vulkan::Pipeline::create_from_rp");
   auto& rp = ovk::system().render_pass[rp_handle];
   auto index = 0;
   for (auto& val : ovk::system().pipeline) {
-    if (!val.initialized()) {
+    if (!val.initialized() && !pending(index)) {
       val = std::move(ovk::Pipeline(rp, info));
       return index;
     }
@@ -554,8 +936,142 @@ auto Vulkan::Pipeline::create_from_rp(int32_t rp_handle,
   return -1;
 }
 
+/** Moves built pipelines into free slots, writing their handles in order.
+ * Slots are claimed on the calling thread only, so the system's tables are
+ * never touched by workers.
+ */
+static auto claim(std::vector<ovk::Pipeline>& pipes, int32_t* handles)
+    -> void {
+  auto index = 0;
+  auto next = size_t(0);
+  for (auto& val : ovk::system().pipeline) {
+    if (next == pipes.size()) return;
+    if (!val.initialized() && !pending(index)) {
+      val = std::move(pipes[next]);
+      handles[next++] = index;
+    }
+    index++;
+  }
+
+  OhmAssert(next < pipes.size(),
+            "Too many pipelines. API has run out of allocation space.");
+  for (; next < pipes.size(); next++) handles[next] = -1;
+}
+
+auto Vulkan::Pipeline::create_many(int gpu, const PipelineInfo* infos,
+                                   size_t count,
+                                   int32_t* handles) Ohm_NOEXCEPT -> void {
+  OhmTraceZone("Vulkan::Pipeline::create_many");
+  auto& device = ovk::system().devices[gpu];
+  auto pipes = std::vector<ovk::Pipeline>(count);
+
+  // Shader compilation and pipeline creation dominate, and both are safe to
+  // run concurrently for distinct pipelines.
+  io::jobs().parallelFor(count, [&pipes, &device, infos](size_t index) {
+    OhmTraceZone("Vulkan::Pipeline::create_many job");
+    pipes[index] = ovk::Pipeline(device, infos[index]);
+  });
+  claim(pipes, handles);
+}
+
+auto Vulkan::Pipeline::create_many_from_rp(int32_t rp_handle,
+                                           const PipelineInfo* infos,
+                                           size_t count,
+                                           int32_t* handles) Ohm_NOEXCEPT
+    -> void {
+  OhmTraceZone("Vulkan::Pipeline::create_many_from_rp");
+  OhmAssert(rp_handle < 0, "Attempting to use an invalid render pass handle.");
+  auto& rp = ovk::system().render_pass[rp_handle];
+  auto pipes = std::vector<ovk::Pipeline>(count);
+
+  io::jobs().parallelFor(count, [&pipes, &rp, infos](size_t index) {
+    OhmTraceZone("Vulkan::Pipeline::create_many_from_rp job");
+    pipes[index] = ovk::Pipeline(rp, infos[index]);
+  });
+  claim(pipes, handles);
+}
+
+auto Vulkan::Pipeline::create_async(int gpu,
+                                    const PipelineInfo& info) Ohm_NOEXCEPT
+    -> int32_t {
+  OhmTraceZone("Vulkan::Pipeline::create_async");
+  auto* device = &ovk::system().devices[gpu];
+  return reserve(io::jobs().async([device, info]() {
+    OhmTraceZone("Vulkan::Pipeline::create_async job");
+    return ovk::Pipeline(*device, info);
+  }));
+}
+
+auto Vulkan::Pipeline::create_async_from_rp(int32_t rp_handle,
+                                            const PipelineInfo& info)
+    Ohm_NOEXCEPT -> int32_t {
+  OhmTraceZone("Vulkan::Pipeline::create_async_from_rp");
+  OhmAssert(rp_handle < 0, "Attempting to use an invalid render pass handle.");
+  auto* rp = &ovk::system().render_pass[rp_handle];
+  return reserve(io::jobs().async([rp, info]() {
+    OhmTraceZone("Vulkan::Pipeline::create_async_from_rp job");
+    return ovk::Pipeline(*rp, info);
+  }));
+}
+
+auto Vulkan::Pipeline::create_shared(int gpu,
+                                     const PipelineInfo& info) Ohm_NOEXCEPT
+    -> int32_t {
+  OhmTraceZone("Vulkan::Pipeline::create_shared");
+  auto& registry = ovk::system().pipeline_registry;
+  auto key = ovk::PipelineRegistry::key(gpu, -1, info);
+  auto handle = registry.acquire(key);
+  if (handle >= 0) return handle;
+
+  handle = Vulkan::Pipeline::create(gpu, info);
+  if (handle >= 0) registry.insert(key, handle);
+  return handle;
+}
+
+auto Vulkan::Pipeline::create_shared_from_rp(int32_t rp_handle,
+                                             const PipelineInfo& info)
+    Ohm_NOEXCEPT -> int32_t {
+  OhmTraceZone("Vulkan::Pipeline::create_shared_from_rp");
+  OhmAssert(rp_handle < 0, "Attempting to use an invalid render pass handle.");
+  auto& registry = ovk::system().pipeline_registry;
+  // The render pass already identifies the device.
+  auto key = ovk::PipelineRegistry::key(-1, rp_handle, info);
+  auto handle = registry.acquire(key);
+  if (handle >= 0) return handle;
+
+  handle = Vulkan::Pipeline::create_from_rp(rp_handle, info);
+  if (handle >= 0) registry.insert(key, handle);
+  return handle;
+}
+
+auto Vulkan::Pipeline::ready(int32_t handle) Ohm_NOEXCEPT -> bool {
+  // Failed and moved-from pipelines have no slot, so are never ready.
+  if (handle < 0) return false;
+  auto& table = ovk::system().pending_pipeline;
+  auto iter = table.find(handle);
+  if (iter == table.end()) return ovk::system().pipeline[handle].initialized();
+
+  // Finished pipelines are moved into their slot here, on the calling thread,
+  // so workers never touch the system's tables.
+  auto status = iter->second.wait_for(std::chrono::seconds(0));
+  if (status != std::future_status::ready) return false;
+
+  ovk::system().pipeline[handle] = iter->second.get();
+  table.erase(iter);
+  return true;
+}
+
+auto Vulkan::Pipeline::wait(int32_t handle) Ohm_NOEXCEPT -> void {
+  OhmTraceZone("Vulkan::Pipeline::wait");
+  while (!Vulkan::Pipeline::ready(handle)) {
+    if (!io::jobs().help()) std::this_thread::yield();
+  }
+}
+
 auto Vulkan::Pipeline::destroy(int32_t handle) Ohm_NOEXCEPT -> void {
   OhmAssert(handle < 0, "Attempting to delete an invalid pipeline handle.");
+  if (ovk::system().pipeline_registry.release(handle)) return;
+  if (pending(handle)) Vulkan::Pipeline::wait(handle);
   auto& pipe = ovk::system().pipeline[handle];
   auto tmp = ovk::Pipeline();
 
@@ -564,12 +1080,13 @@ auto Vulkan::Pipeline::destroy(int32_t handle) Ohm_NOEXCEPT -> void {
   tmp = std::move(pipe);
 }
 
-auto Vulkan::Pipeline::descriptor(int32_t handle) Ohm_NOEXCEPT -> int32_t {
-  auto& pipeline = ovk::system().pipeline[handle];
+/** Moves a descriptor into the first free descriptor slot.
+ */
+static auto insert(ovk::Descriptor descriptor) -> int32_t {
   auto index = 0;
   for (auto& val : ovk::system().descriptor) {
     if (!val.initialized()) {
-      val = std::move(pipeline.descriptor());
+      val = std::move(descriptor);
       return index;
     }
     index++;
@@ -579,6 +1096,46 @@ auto Vulkan::Pipeline::descriptor(int32_t handle) Ohm_NOEXCEPT -> int32_t {
   return -1;
 }
 
+auto Vulkan::Pipeline::descriptor(int32_t handle) Ohm_NOEXCEPT -> int32_t {
+  if (pending(handle)) Vulkan::Pipeline::wait(handle);
+  auto& pipeline = ovk::system().pipeline[handle];
+  return insert(pipeline.descriptor());
+}
+
+auto Vulkan::Pipeline::transient_descriptor(int32_t handle) Ohm_NOEXCEPT
+    -> int32_t {
+  OhmAssert(handle < 0, "Attempting to use an invalid pipeline handle.");
+  if (pending(handle)) Vulkan::Pipeline::wait(handle);
+  auto& pipeline = ovk::system().pipeline[handle];
+  OhmAssert(!pipeline.initialized(),
+            "Attempting to use a pipeline object that is not initialized.");
+  return insert(pipeline.transientDescriptor());
+}
+
+auto Vulkan::Pipeline::retire(int32_t handle, int32_t commands) Ohm_NOEXCEPT
+    -> void {
+  OhmAssert(handle < 0, "Attempting to use an invalid pipeline handle.");
+  OhmAssert(commands < 0, "Attempting to use an invalid commands handle.");
+  if (pending(handle)) Vulkan::Pipeline::wait(handle);
+  auto& pipeline = ovk::system().pipeline[handle];
+  auto& cmd = ovk::system().commands[commands];
+  OhmAssert(!pipeline.initialized(),
+            "Attempting to use a pipeline object that is not initialized.");
+  OhmAssert(!cmd.initialized(),
+            "Attempting to use object that is not initialized.");
+  pipeline.retire(cmd.submitted());
+}
+
+auto Vulkan::Pipeline::binding(int32_t handle, uint64_t hash) Ohm_NOEXCEPT
+    -> int32_t {
+  OhmAssert(handle < 0, "Attempting to use an invalid pipeline handle.");
+  if (pending(handle)) Vulkan::Pipeline::wait(handle);
+  auto& pipeline = ovk::system().pipeline[handle];
+  OhmAssert(!pipeline.initialized(),
+            "Attempting to use a pipeline object that is not initialized.");
+  return pipeline.binding(hash);
+}
+
 auto Vulkan::Descriptor::destroy(int32_t handle) -> void {
   OhmAssert(handle < 0, "Attempting to delete an invalid descriptor handle.");
   auto& val = ovk::system().descriptor[handle];
@@ -634,6 +1191,59 @@ auto Vulkan::Descriptor::bind_images(int32_t handle, std::string_view name,
   val.bind(name, images_to_bind.data(), images.size());
 }
 
+auto Vulkan::Descriptor::bind_array(int32_t handle, int32_t binding,
+                                    int32_t array) -> void {
+  OhmAssert(handle < 0, "Attempting to use an invalid descriptor handle.");
+  auto& val = ovk::system().descriptor[handle];
+  auto& arr = ovk::system().buffer[array];
+  OhmAssert(!val.initialized(),
+            "Attempting to use a descriptor object that is not initialized.");
+  OhmAssert(!arr.initialized(),
+            "Attempting to use an array object that is not initialized.");
+
+  val.bind(binding, arr);
+}
+
+auto Vulkan::Descriptor::bind_image(int32_t handle, int32_t binding,
+                                    int32_t image) -> void {
+  OhmAssert(handle < 0, "Attempting to use an invalid descriptor handle.");
+  auto& val = ovk::system().descriptor[handle];
+  auto& img = ovk::system().image[image];
+  OhmAssert(!val.initialized(),
+            "Attempting to use a descriptor object that is not initialized.");
+  OhmAssert(!img.initialized(),
+            "Attempting to use an image object that is not initialized.");
+
+  val.bind(binding, img);
+}
+
+auto Vulkan::Descriptor::bind_images(int32_t handle, int32_t binding,
+                                     const std::vector<int32_t>& images)
+    -> void {
+  auto images_to_bind = std::vector<const ovk::Image*>();
+  images_to_bind.reserve(images.size());
+
+  OhmAssert(handle < 0, "Attempting to use an invalid descriptor handle.");
+  auto& val = ovk::system().descriptor[handle];
+
+  for (auto& image : images) {
+    auto& img = ovk::system().image[image];
+    OhmAssert(!img.initialized(), "Attempting to bind an invalid image.");
+    images_to_bind.push_back(&img);
+  }
+
+  val.bind(binding, images_to_bind.data(), images.size());
+}
+
+auto Vulkan::Descriptor::commit(int32_t handle) -> void {
+  OhmAssert(handle < 0, "Attempting to use an invalid descriptor handle.");
+  auto& val = ovk::system().descriptor[handle];
+  OhmAssert(!val.initialized(),
+            "Attempting to use a descriptor object that is not initialized.");
+
+  val.commit();
+}
+
 auto Vulkan::Event::create() Ohm_NOEXCEPT -> int32_t {
   static auto id = std::atomic<int32_t>{0};
 
@@ -739,6 +1349,7 @@ auto Vulkan::Window::wait(int32_t handle, int32_t cmd) Ohm_NOEXCEPT -> void {
 }
 
 auto Vulkan::Window::present(int32_t handle) Ohm_NOEXCEPT -> bool {
+  OhmTraceZone("Vulkan::Window::present");
   OhmAssert(handle < 0, "Accessing invalid handle!");
   auto& swapchain = ovk::system().swapchain[handle];
   OhmAssert(!swapchain.initialized(), "Accessing invalid swapchain!");
@@ -19,6 +19,10 @@ struct Vulkan {
     static auto name() Ohm_NOEXCEPT -> std::string;
     static auto set_parameter(std::string_view str) Ohm_NOEXCEPT -> void;
     static auto set_debug_parameter(std::string_view str) Ohm_NOEXCEPT -> void;
+    static auto set_pipeline_cache(std::string_view directory) Ohm_NOEXCEPT
+        -> void;
+    static auto save_pipeline_cache() Ohm_NOEXCEPT -> void;
+    static auto set_bindless(bool enable) Ohm_NOEXCEPT -> void;
     static auto devices() Ohm_NOEXCEPT -> std::vector<Gpu>;
   };
 
@@ -44,6 +48,7 @@ struct Vulkan {
     static auto required(int32_t handle) Ohm_NOEXCEPT -> size_t;
     static auto bind(int32_t array_handle, int32_t memory_handle) Ohm_NOEXCEPT
         -> void;
+    static auto bindless(int32_t handle) Ohm_NOEXCEPT -> int32_t;
   };
 
   /** Image-related function API
@@ -55,6 +60,7 @@ struct Vulkan {
     static auto required(int32_t handle) Ohm_NOEXCEPT -> size_t;
     static auto bind(int32_t image_handle, int32_t mem_handle) Ohm_NOEXCEPT
         -> void;
+    static auto bindless(int32_t handle) Ohm_NOEXCEPT -> int32_t;
   };
 
   /** Commands-related function API
@@ -65,6 +71,21 @@ struct Vulkan {
     static auto begin(int32_t handle) Ohm_NOEXCEPT -> void;
     static auto draw(int32_t handle, int32_t vertices, size_t instance_count) Ohm_NOEXCEPT -> void;
     static auto draw_indexed(int32_t handle, int32_t indices, int32_t vertices, size_t instance_count) Ohm_NOEXCEPT -> void;
+    static auto draw_indirect(int32_t handle, int32_t vertices, int32_t args,
+                              size_t draw_count, size_t offset) Ohm_NOEXCEPT
+        -> void;
+    static auto draw_indirect_count(int32_t handle, int32_t vertices,
+                                    int32_t args, int32_t count,
+                                    size_t max_draws) Ohm_NOEXCEPT -> void;
+    static auto draw_indexed_indirect(int32_t handle, int32_t indices,
+                                      int32_t vertices, int32_t args,
+                                      size_t draw_count,
+                                      size_t offset) Ohm_NOEXCEPT -> void;
+    static auto draw_indexed_indirect_count(int32_t handle, int32_t indices,
+                                            int32_t vertices, int32_t args,
+                                            int32_t count,
+                                            size_t max_draws) Ohm_NOEXCEPT
+        -> void;
     static auto bind(int32_t handle, int32_t desc) Ohm_NOEXCEPT -> void;
     static auto copy_to_image(int32_t handle, int32_t src, int32_t dst,
                               size_t count) Ohm_NOEXCEPT -> void;
@@ -76,8 +97,29 @@ struct Vulkan {
                            size_t count) Ohm_NOEXCEPT -> void;
     static auto copy_array(int32_t handle, const void* src, int32_t dst,
                            size_t count) Ohm_NOEXCEPT -> void;
+    static auto copy_array(int32_t handle, int32_t src, int32_t dst,
+                           const ArrayRegion* regions,
+                           size_t region_count) Ohm_NOEXCEPT -> void;
+    static auto copy_to_image(int32_t handle, int32_t src, int32_t dst,
+                              const ImageRegion* regions,
+                              size_t region_count) Ohm_NOEXCEPT -> void;
+    static auto copy_from_image(int32_t handle, int32_t src, int32_t dst,
+                                const ImageRegion* regions,
+                                size_t region_count) Ohm_NOEXCEPT -> void;
+    static auto copy_image(int32_t handle, int32_t src, int32_t dst,
+                           const ImageCopyRegion* regions,
+                           size_t region_count) Ohm_NOEXCEPT -> void;
+    static auto fill(int32_t handle, int32_t dst, uint32_t value,
+                     size_t offset, size_t count) Ohm_NOEXCEPT -> void;
+    static auto update(int32_t handle, int32_t dst, const void* src,
+                       size_t count, size_t offset) Ohm_NOEXCEPT -> void;
+    static auto barrier(int32_t handle) Ohm_NOEXCEPT -> void;
     static auto dispatch(int32_t handle, size_t x, size_t y,
                          size_t z) Ohm_NOEXCEPT -> void;
+    static auto dispatch_indirect(int32_t handle, int32_t args,
+                                  size_t offset) Ohm_NOEXCEPT -> void;
+    static auto push(int32_t handle, const void* data, size_t size,
+                     size_t offset) Ohm_NOEXCEPT -> void;
     static auto submit(int32_t handle) Ohm_NOEXCEPT -> void;
     static auto blit_to_window(int32_t handle, int32_t src, int32_t dst,
                                Filter filter) Ohm_NOEXCEPT -> void;
@@ -86,6 +128,14 @@ struct Vulkan {
     static auto blit_from_renderpass(int32_t handle, int32_t src, int32_t dst,
                                      Filter filter) Ohm_NOEXCEPT -> void;
     static auto synchronize(int32_t handle) Ohm_NOEXCEPT -> void;
+    static auto skipped_binds(int32_t handle) Ohm_NOEXCEPT -> size_t;
+    static auto profile(int32_t handle, bool enable,
+                        bool statistics) Ohm_NOEXCEPT -> void;
+    static auto begin_scope(int32_t handle,
+                            std::string_view name) Ohm_NOEXCEPT -> void;
+    static auto end_scope(int32_t handle) Ohm_NOEXCEPT -> void;
+    static auto scopes(int32_t handle) Ohm_NOEXCEPT
+        -> std::vector<ScopeTiming>;
   };
 
   struct RenderPass {
@@ -104,8 +154,29 @@ struct Vulkan {
     static auto create_from_rp(int32_t rp_handle,
                                const PipelineInfo& info) Ohm_NOEXCEPT
         -> int32_t;
+    static auto create_many(int gpu, const PipelineInfo* infos, size_t count,
+                            int32_t* handles) Ohm_NOEXCEPT -> void;
+    static auto create_many_from_rp(int32_t rp_handle,
+                                    const PipelineInfo* infos, size_t count,
+                                    int32_t* handles) Ohm_NOEXCEPT -> void;
+    static auto create_async(int gpu, const PipelineInfo& info) Ohm_NOEXCEPT
+        -> int32_t;
+    static auto create_async_from_rp(int32_t rp_handle,
+                                     const PipelineInfo& info) Ohm_NOEXCEPT
+        -> int32_t;
+    static auto create_shared(int gpu, const PipelineInfo& info) Ohm_NOEXCEPT
+        -> int32_t;
+    static auto create_shared_from_rp(int32_t rp_handle,
+                                      const PipelineInfo& info) Ohm_NOEXCEPT
+        -> int32_t;
+    static auto ready(int32_t handle) Ohm_NOEXCEPT -> bool;
+    static auto wait(int32_t handle) Ohm_NOEXCEPT -> void;
     static auto destroy(int32_t handle) Ohm_NOEXCEPT -> void;
     static auto descriptor(int32_t handle) Ohm_NOEXCEPT -> int32_t;
+    static auto transient_descriptor(int32_t handle) Ohm_NOEXCEPT -> int32_t;
+    static auto retire(int32_t handle, int32_t commands) Ohm_NOEXCEPT -> void;
+    static auto binding(int32_t handle, uint64_t hash) Ohm_NOEXCEPT
+        -> int32_t;
   };
 
   /** Descriptor-related function API
@@ -118,6 +189,13 @@ struct Vulkan {
         -> void;
     static auto bind_images(int32_t handle, std::string_view name,
                             const std::vector<int32_t>& images) -> void;
+    static auto bind_array(int32_t handle, int32_t binding, int32_t array)
+        -> void;
+    static auto bind_image(int32_t handle, int32_t binding, int32_t image)
+        -> void;
+    static auto bind_images(int32_t handle, int32_t binding,
+                            const std::vector<int32_t>& images) -> void;
+    static auto commit(int32_t handle) -> void;
   };
 
   /** Event-related function API